@@ -1,20 +1,215 @@
+#define _GNU_SOURCE // Requerido por sched_setaffinity e sched_getcpu.
 #include <stdio.h>
 #include <locale.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h> // Requerido por fork, getpid e getppid.
 #include <sys/wait.h> // Requerido por wait.
+#include <sys/mman.h> // Requerido por mmap.
+#include <getopt.h> // Requerido por getopt_long.
+#include <time.h> // Requerido por clock_gettime.
+#include <limits.h> // Requerido por UINT_MAX.
+#include <signal.h> // Requerido por signal.
+#include <sys/socket.h> // Requerido por socket, bind, listen e accept.
+#include <sys/un.h> // Requerido por sockaddr_un.
+#include <sys/stat.h> // Requerido por stat.
+#include <glob.h> // Requerido por glob.
+#include <sys/resource.h> // Requerido por getrusage.
+#include <fcntl.h> // Requerido por O_WRONLY.
+#include <spawn.h> // Requerido por posix_spawnp.
+#include <dlfcn.h> // Requerido por dlopen e dlsym.
+#include <errno.h> // Requerido por errno.
+#include <sys/syscall.h> // Requerido por SYS_perf_event_open.
+#include <linux/perf_event.h> // Requerido por perf_event_attr.
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // Requerido pelos kernels SSE4.1 e AVX2.
+#define SIMD_X86
+#endif
 #include "tes.h"
 
-int main(){
+// Opções informadas na linha de comando.
+Configuracao configuracao;
+
+// Cache de resultados compartilhado (--memo), ou NULL sem memoização.
+CacheResultados *cacheResultados = NULL;
+
+// Índice das imagens de código compartilhadas pelas tarefas que executam o mesmo programa.
+IndiceImagens indiceImagens = {PTHREAD_MUTEX_INITIALIZER, {NULL}, 0};
+
+// Kernels das instruções de vetor, selecionados conforme o processador antes da criação dos processos e das threads.
+KernelAritmetico kernelVetor;
+KernelReducao kernelReducao;
+
+// Deslocamento do índice de afinidade dos processos tes (no modo servidor, a vaga do trabalho).
+int deslocamentoAfinidade = 0;
+
+// Contexto de strtok_r compartilhado por identificarInstrucao e obterArgumento (um por thread).
+static __thread char *contextoInstrucao;
+
+int main(int argc, char *argv[]){
+    const char *nomeKernel;
+    GrupoContadores grupo;
+
+    if(!lerOpcoes(argc, argv, &configuracao)){
+        printf(ERRO_OPCAO_INVALIDA);
+        return EXIT_FAILURE;
+    }
+
+    kernelVetor = selecionarKernelAritmetico(&nomeKernel);
+    kernelReducao = selecionarKernelReducao();
+
+    // Os objetos do cache são executados pelo tes: um diretório que outro usuário pode alterar não é usado.
+    if(configuracao.diretorioNativo && !prepararDiretorioNativo(configuracao.diretorioNativo)){
+        printf(ERRO_DIRETORIO_NATIVO, configuracao.diretorioNativo);
+        configuracao.diretorioNativo = NULL;
+    }
+
+    // O cache é criado antes de qualquer processo ou thread, para ser compartilhado por todos.
+    if(configuracao.capacidadeMemo)
+        cacheResultados = criarCacheResultados(configuracao.capacidadeMemo);
+
+    if(configuracao.programaSimd)
+        return executarModoSimd(configuracao.programaSimd, configuracao.arquivoEntradas);
+
+    if(configuracao.programaMap)
+        return executarModoMap(configuracao.programaMap, configuracao.arquivoEntradas, configuracao.arquivoSaida);
+
+    // O acesso aos contadores de hardware é verificado uma única vez, antes dos processos tes: sem acesso, eles executam sem medição.
+    if(configuracao.contadores){
+        if(abrirContadoresHardware(&grupo))
+            fecharContadoresHardware(&grupo);
+        else {
+            printf(ERRO_CONTADORES, strerror(errno));
+            configuracao.contadores = FALSE;
+        }
+    }
+
+    if(configuracao.caminhoServidor)
+        return executarModoServidor(configuracao.caminhoServidor, configuracao.concorrencia);
+
     return tes();
 }
 
-int tes(){
-    char *linhaDeComando;
+int lerOpcoes(int argc, char *argv[], Configuracao *configuracao){
+    struct option opcoes[] = {
+        {OPCAO_MIGRAR, no_argument, &configuracao->migracao, TRUE},
+        {OPCAO_SIMD, required_argument, NULL, 's'},
+        {OPCAO_MAP, required_argument, NULL, 'm'},
+        {OPCAO_SAIDA, required_argument, NULL, 'o'},
+        {OPCAO_TRACE, required_argument, NULL, 't'},
+        {OPCAO_GANTT, no_argument, &configuracao->gantt, TRUE},
+        {OPCAO_LATENCIA_ES, required_argument, NULL, 'l'},
+        {OPCAO_EVENTOS, no_argument, &configuracao->eventos, TRUE},
+        {OPCAO_CONTADORES, no_argument, &configuracao->contadores, TRUE},
+        {OPCAO_LIMITE_CPU, required_argument, NULL, 'u'},
+        {OPCAO_LIMITE_TEMPO, required_argument, NULL, 'w'},
+        {OPCAO_LIMITE_VARIAVEIS, required_argument, NULL, 'v'},
+        {OPCAO_SERVIDOR, required_argument, NULL, 'S'},
+        {OPCAO_CONCORRENCIA, required_argument, NULL, 'c'},
+        {OPCAO_AFINIDADE, optional_argument, NULL, 'a'},
+        {OPCAO_AFINIDADE_COMPARTILHADA, no_argument, NULL, 'A'},
+        {OPCAO_AOT, optional_argument, NULL, 'n'},
+        {OPCAO_MEMO, optional_argument, NULL, 'M'},
+        {0, 0, 0, 0}
+    };
+    cpu_set_t permitidos, nucleos;
+    int opcao;
+
+    memset(configuracao, 0, sizeof(Configuracao));
+    configuracao->concorrencia = sysconf(_SC_NPROCESSORS_ONLN);
+    CPU_ZERO(&nucleos);
+
+    while((opcao = getopt_long(argc, argv, "", opcoes, NULL)) != -1){
+        if(opcao == 's')
+            configuracao->programaSimd = optarg;
+        else if(opcao == 'm')
+            configuracao->programaMap = optarg;
+        else if(opcao == 'o')
+            configuracao->arquivoSaida = optarg;
+        else if(opcao == 't')
+            configuracao->prefixoTrace = optarg;
+        else if(opcao == 'u'){
+            if(!converterNumero(optarg, &configuracao->limiteCPU) || configuracao->limiteCPU < 1 || configuracao->limiteCPU > USHRT_MAX)
+                return FALSE;
+        }
+        else if(opcao == 'w'){
+            if(!converterNumero(optarg, &configuracao->limiteTempoMs) || configuracao->limiteTempoMs < 1)
+                return FALSE;
+        }
+        else if(opcao == 'v'){
+            if(!converterNumero(optarg, &configuracao->limiteVariaveis) || configuracao->limiteVariaveis < 1)
+                return FALSE;
+        }
+        else if(opcao == 'S')
+            configuracao->caminhoServidor = optarg;
+        else if(opcao == 'c'){
+            if(!converterNumero(optarg, &configuracao->concorrencia) || configuracao->concorrencia < 1)
+                return FALSE;
+        }
+        else if(opcao == 'a'){
+            configuracao->afinidade = TRUE;
+            if(optarg && !lerListaNucleos(optarg, &nucleos))
+                return FALSE;
+        }
+        else if(opcao == 'A')
+            configuracao->afinidadeCompartilhada = TRUE;
+        else if(opcao == 'n')
+            configuracao->diretorioNativo = optarg ? optarg : DIRETORIO_NATIVO_PADRAO;
+        else if(opcao == 'M'){
+            configuracao->capacidadeMemo = CAPACIDADE_MEMO_PADRAO;
+            if(optarg && (!converterNumero(optarg, &configuracao->capacidadeMemo) || configuracao->capacidadeMemo < 1))
+                return FALSE;
+        }
+        else if(opcao == 'l'){
+            if(!converterNumero(optarg, &configuracao->latenciaES) || configuracao->latenciaES < 0 || configuracao->latenciaES > LATENCIA_ES_MAXIMA)
+                return FALSE;
+        }
+        else if(opcao != 0)
+            return FALSE;
+    }
 
-    Tarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS];
-    unsigned short quantidadeProgramas;
+    // Os modos em lote recebem o arquivo de entradas como argumento posicional.
+    if(configuracao->programaSimd && configuracao->programaMap)
+        return FALSE;
+
+    // No modo servidor as entradas pertencem à tarefa e não acompanham uma tarefa migrada.
+    if(configuracao->caminhoServidor && (configuracao->programaSimd || configuracao->programaMap || configuracao->migracao))
+        return FALSE;
+
+    if(configuracao->concorrencia < 1)
+        configuracao->concorrencia = 1;
+
+    if(configuracao->afinidadeCompartilhada && !configuracao->afinidade)
+        return FALSE;
+
+    // Sem lista, a afinidade usa todos os núcleos em que o processo pode executar; uma lista informada deve estar contida neles.
+    if(configuracao->afinidade){
+        if(sched_getaffinity(0, sizeof(permitidos), &permitidos) < 0)
+            return FALSE;
+
+        if(CPU_COUNT(&nucleos) == 0)
+            nucleos = permitidos;
+        else{
+            CPU_AND(&permitidos, &permitidos, &nucleos);
+            if(!CPU_EQUAL(&permitidos, &nucleos))
+                return FALSE;
+        }
+
+        ordenarNucleos(&nucleos, configuracao);
+    }
+
+    if(configuracao->programaSimd || configuracao->programaMap){
+        if(optind != argc - 1) return FALSE;
+        configuracao->arquivoEntradas = argv[optind++];
+    }
+
+    return (optind == argc) ? TRUE : FALSE;
+}
+
+int tes(){
+    char *linhaDeComando, *argumento, *contexto;
+    NomePrograma *nomes = NULL;
+    int quantidadeProgramas, capacidade = 0;
 
     setlocale(LC_ALL, "pt-BR");
 
@@ -27,15 +222,21 @@ int tes(){
         if(!linhaDeComando) continue; // Verifica se a linha de comando está vazia, igual à NULL
         if(isExit(linhaDeComando)) break; // Verifica se o comando digitado é EXIT
 
-        quantidadeProgramas = obterNomesProgramas(linhaDeComando, tarefas);
-        quantidadeProgramas = obterInstrucoesProgramas(tarefas, quantidadeProgramas);
+        // Cada argumento pode ser o nome de um programa, um diretório ou um padrão glob.
+        quantidadeProgramas = 0;
+        for(argumento = strtok_r(linhaDeComando, DELIMITADOR, &contexto); argumento && quantidadeProgramas != NAO_ENCONTRADO; argumento = strtok_r(NULL, DELIMITADOR, &contexto))
+            quantidadeProgramas = expandirProgramas(argumento, &nomes, quantidadeProgramas, &capacidade);
 
-        executarProgramas(tarefas, quantidadeProgramas);
+        if(quantidadeProgramas == NAO_ENCONTRADO)
+            printf(ERRO_MEMORIA_INSUFICIENTE);
+        else
+            executarProgramasCarregados(nomes, quantidadeProgramas);
 
         free(linhaDeComando);
     }
 
     free(linhaDeComando);
+    free(nomes);
 
     return EXIT_SUCCESS;
 } // tes()
@@ -56,334 +257,892 @@ char * lerComando(){
     return comando;
 }
 
-unsigned short obterNomesProgramas(const char *linhaDeComando, Tarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS]){
-    unsigned short cont;
-    char copiaLinhaComando[TAMANHO_LINHA_COMANDO], *tok;
+int expandirProgramas(const char *argumento, NomePrograma **nomes, int quantidade, int *capacidade){
+    char padrao[TAMANHO_NOME_ARQUIVO * 2], base[TAMANHO_NOME_ARQUIVO];
+    const char *caminho, *chegada;
+    struct stat informacoes;
+    size_t tamanho, tamanhoExtensao = strlen(EXTENSAO_LPAS);
+    NomePrograma *novos;
+    glob_t arquivos;
+    size_t quantidadeArquivos = 1;
+
+    // O instante de chegada (nome@ut) vale para todos os programas do argumento e é verificado na carga de cada um.
+    if(!(chegada = procurarSeparadorChegada(argumento)))
+        chegada = argumento + strlen(argumento);
+    if(snprintf(base, sizeof(base), "%.*s", (int) (chegada - argumento), argumento) >= (int) sizeof(base)){
+        printf(ERRO_NOME_LONGO, argumento, TAMANHO_NOME_ARQUIVO - 1);
+        return quantidade;
+    }
+
+    // Um diretório equivale ao padrão diretorio/*.lpas.
+    if(stat(base, &informacoes) == 0 && S_ISDIR(informacoes.st_mode))
+        snprintf(padrao, sizeof(padrao), "%s/*%s", base, EXTENSAO_LPAS);
+    else
+        snprintf(padrao, sizeof(padrao), "%s", base);
+
+    memset(&arquivos, 0, sizeof(arquivos));
+    if(strpbrk(padrao, "*?[") && glob(padrao, 0, NULL, &arquivos) == 0)
+        quantidadeArquivos = arquivos.gl_pathc;
+
+    for(size_t i = 0; i < quantidadeArquivos; i++){
+        caminho = arquivos.gl_pathc ? arquivos.gl_pathv[i] : base;
+        tamanho = strlen(caminho);
+
+        // O nome do programa não inclui a extensão; os arquivos do padrão que não são programas LPAS são ignorados.
+        if(tamanho >= tamanhoExtensao && !strcmp(caminho + tamanho - tamanhoExtensao, EXTENSAO_LPAS))
+            tamanho -= tamanhoExtensao;
+        else if(arquivos.gl_pathc)
+            continue;
+
+        if(quantidade == *capacidade){
+            if(!(novos = realloc(*nomes, (*capacidade ? *capacidade * 2 : NUMERO_MAXIMO_DE_PROGRAMAS) * sizeof(NomePrograma)))){
+                globfree(&arquivos);
+                return NAO_ENCONTRADO;
+            }
+            *nomes = novos;
+            *capacidade = *capacidade ? *capacidade * 2 : NUMERO_MAXIMO_DE_PROGRAMAS;
+        }
+
+        // Um nome cortado apontaria para outro arquivo (ou para nenhum): o caminho completo é informado e ignorado.
+        if(snprintf((*nomes)[quantidade], TAMANHO_NOME_ARQUIVO, "%.*s%s", (int) tamanho, caminho, chegada) >= TAMANHO_NOME_ARQUIVO){
+            printf(ERRO_NOME_LONGO, caminho, TAMANHO_NOME_ARQUIVO - 1);
+            continue;
+        }
+        quantidade++;
+    }
+
+    globfree(&arquivos);
+    return quantidade;
+}
+
+void executarProgramasCarregados(NomePrograma nomes[], int quantidade){
+    CarregadorProgramas carregador;
+    Tarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS], *tarefa;
+    HistogramasLatencia *latencias;
+    unsigned short quantidadeGrupo = 0;
 
-    strcpy(copiaLinhaComando, linhaDeComando);
-    strcpy(tarefas[0].programa.nome, strtok(copiaLinhaComando, DELIMITADOR));
+    if(quantidade == 0)
+        return;
 
-    for(cont = 1, tok = strtok(NULL, DELIMITADOR); cont < NUMERO_MAXIMO_DE_PROGRAMAS; cont++, tok = strtok(NULL, DELIMITADOR)){
-        if(!tok) break;
-        strcpy(tarefas[cont].programa.nome, tok);
+    if(!iniciarCarregador(&carregador, nomes, quantidade)){
+        printf(ERRO_MEMORIA_INSUFICIENTE);
+        return;
     }
 
-    return cont;
+    // Os processos de todos os grupos acumulam as suas latências na mesma distribuição.
+    latencias = criarHistogramasCompartilhados();
+
+    for(int i = 0; i < quantidade; i++){
+        if((tarefa = aguardarPrograma(&carregador, i))){
+            tarefas[quantidadeGrupo++] = *tarefa;
+            free(tarefa);
+        }
+
+        // Cada grupo é executado assim que é carregado, enquanto as threads continuam carregando os próximos programas.
+        if(quantidadeGrupo == NUMERO_MAXIMO_DE_PROGRAMAS || (quantidadeGrupo > 0 && i == quantidade - 1)){
+            executarProgramas(tarefas, quantidadeGrupo, latencias);
+            // As imagens ainda referenciadas pelos programas já carregados dos próximos grupos são mantidas.
+            for(int j = 0; j < quantidadeGrupo; j++)
+                liberarImagemPrograma(tarefas[j].imagem);
+            quantidadeGrupo = 0;
+        }
+    }
+
+    encerrarCarregador(&carregador);
+
+    if(latencias){
+        exibirLatenciasCombinadas(TITULO_LATENCIAS_PROCESSOS, latencias);
+        destruirHistogramasCompartilhados(latencias);
+    }
+
+    if(cacheResultados){
+        exibirMemoizacao();
+        printf("\n\n");
+    }
+}
+
+int iniciarCarregador(CarregadorProgramas *carregador, NomePrograma nomes[], int quantidade){
+    long quantidadeThreads = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if(quantidadeThreads > quantidade) quantidadeThreads = quantidade;
+    if(quantidadeThreads < 1) quantidadeThreads = 1;
+
+    carregador->nomes = nomes;
+    carregador->quantidade = quantidade;
+    carregador->proximo = carregador->consumidos = 0;
+    carregador->tarefas = calloc(quantidade, sizeof(Tarefa *));
+    carregador->estados = calloc(quantidade, sizeof(unsigned char)); // CARGA_PENDENTE.
+    carregador->erros = malloc(quantidade * sizeof(ErroExecucao));
+    carregador->threads = malloc(quantidadeThreads * sizeof(pthread_t));
+
+    if(!carregador->tarefas || !carregador->estados || !carregador->erros || !carregador->threads){
+        free(carregador->tarefas);
+        free(carregador->estados);
+        free(carregador->erros);
+        free(carregador->threads);
+        return FALSE;
+    }
+
+    pthread_mutex_init(&carregador->trava, NULL);
+    pthread_cond_init(&carregador->carregado, NULL);
+    pthread_cond_init(&carregador->consumido, NULL);
+
+    for(carregador->quantidadeThreads = 0; carregador->quantidadeThreads < quantidadeThreads; carregador->quantidadeThreads++)
+        if(pthread_create(&carregador->threads[carregador->quantidadeThreads], NULL, carregarProgramas, carregador) != 0)
+            break;
+
+    // Sem nenhuma thread de carga os programas nunca seriam carregados.
+    if(carregador->quantidadeThreads == 0){
+        encerrarCarregador(carregador);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void * carregarProgramas(void *argumento){
+    CarregadorProgramas *carregador = argumento;
+    ErroExecucao erro;
+    EstadoCarga estado;
+    Tarefa *tarefa;
+    int index;
+
+    while(TRUE){
+        pthread_mutex_lock(&carregador->trava);
+        while(carregador->proximo < carregador->quantidade && carregador->proximo >= carregador->consumidos + JANELA_CARREGAMENTO)
+            pthread_cond_wait(&carregador->consumido, &carregador->trava);
+
+        if(carregador->proximo >= carregador->quantidade){
+            pthread_mutex_unlock(&carregador->trava);
+            break;
+        }
+        index = carregador->proximo++;
+        pthread_mutex_unlock(&carregador->trava);
+
+        // A carga (leitura do arquivo e verificação) é feita fora da trava.
+        if((tarefa = malloc(sizeof(Tarefa)))){
+            estado = carregarPrograma(carregador->nomes[index], tarefa, &erro);
+            if(estado != CARGA_CONCLUIDA){
+                free(tarefa);
+                tarefa = NULL;
+            }
+        } else {
+            estado = CARGA_INEXISTENTE;
+            snprintf(erro.nome, TAMANHO_NOME_ARQUIVO, "%s", carregador->nomes[index]);
+        }
+
+        pthread_mutex_lock(&carregador->trava);
+        carregador->tarefas[index] = tarefa;
+        carregador->erros[index] = erro;
+        carregador->estados[index] = estado;
+        pthread_cond_broadcast(&carregador->carregado);
+        pthread_mutex_unlock(&carregador->trava);
+    }
+
+    return NULL;
 }
 
-unsigned short obterInstrucoesProgramas(Tarefa tarefas[], unsigned short quantidadeProgramas){
+EstadoCarga carregarPrograma(const char *nome, Tarefa *tarefa, ErroExecucao *erro){
+    char nomeArquivo[TAMANHO_NOME_ARQUIVO + sizeof(EXTENSAO_LPAS)];
+    Programa programa;
     FILE *arquivo;
-    char nomeArquivo[TAMANHO_NOME_ARQUIVO];
-    for(int i = 0; i < quantidadeProgramas; i++){
-        strcpy(nomeArquivo, tarefas[i].programa.nome);
 
-        arquivo = fopen(strcat(nomeArquivo, EXTENSAO_LPAS), APENAS_LEITURA);
-        if(!arquivo){
+    snprintf(tarefa->nome, TAMANHO_NOME_ARQUIVO, "%s", nome);
+    tarefa->memoizada = FALSE;
+    tarefa->entradas = NULL; // Os valores dos READs são digitados.
+    if(!separarChegada(tarefa->nome, &tarefa->chegada))
+        return CARGA_INEXISTENTE;
+    snprintf(nomeArquivo, sizeof(nomeArquivo), "%s%s", tarefa->nome, EXTENSAO_LPAS);
+
+    if(!(arquivo = fopen(nomeArquivo, APENAS_LEITURA)))
+        return CARGA_INEXISTENTE;
+
+    // O texto é lido em um buffer da thread de carga; a tarefa guarda somente a referência à imagem compartilhada.
+    snprintf(programa.nome, TAMANHO_NOME_ARQUIVO, "%s", tarefa->nome);
+    programa.numeroDeInstrucoes = lerInstrucoesDoArquivo(&programa, arquivo);
+    fclose(arquivo);
+
+    // A verificação e a compilação também são feitas pelas threads de carga, em paralelo com a execução dos grupos já carregados.
+    if(!(tarefa->imagem = obterImagemPrograma(&programa, erro)))
+        return CARGA_INVALIDA;
+
+    return CARGA_CONCLUIDA;
+}
+
+Tarefa * aguardarPrograma(CarregadorProgramas *carregador, int index){
+    Tarefa *tarefa;
+
+    pthread_mutex_lock(&carregador->trava);
+    while(carregador->estados[index] == CARGA_PENDENTE)
+        pthread_cond_wait(&carregador->carregado, &carregador->trava);
+
+    tarefa = carregador->tarefas[index];
+    carregador->tarefas[index] = NULL;
+    carregador->consumidos = index + 1;
+    pthread_cond_broadcast(&carregador->consumido);
+    pthread_mutex_unlock(&carregador->trava);
+
+    return tarefa;
+}
+
+void encerrarCarregador(CarregadorProgramas *carregador){
+    char nomeArquivo[TAMANHO_NOME_ARQUIVO + sizeof(EXTENSAO_LPAS)];
+
+    for(long i = 0; i < carregador->quantidadeThreads; i++)
+        pthread_join(carregador->threads[i], NULL);
+
+    // Erros coletados pelas threads de carga, na ordem dos programas.
+    for(int i = 0; i < carregador->quantidade; i++){
+        if(carregador->estados[i] == CARGA_INEXISTENTE){
+            snprintf(nomeArquivo, sizeof(nomeArquivo), "%s%s", carregador->nomes[i], EXTENSAO_LPAS);
             printf(ERRO_PROGRAMA_NAO_EXISTE, nomeArquivo);
-            tarefas[i--] = tarefas[--quantidadeProgramas]; // Substitui o arquivo não encontrado pelo último do vetor.
-        }else{
-            tarefas[i].programa.numeroDeInstrucoes = lerInstrucoesDoArquivo(&tarefas[i].programa, arquivo);
-            fclose(arquivo);
+        } else if(carregador->estados[i] == CARGA_INVALIDA)
+            imprimirDadosErro(carregador->erros[i]);
+        if(carregador->tarefas[i])
+            liberarImagemPrograma(carregador->tarefas[i]->imagem);
+        free(carregador->tarefas[i]);
+    }
+
+    pthread_mutex_destroy(&carregador->trava);
+    pthread_cond_destroy(&carregador->carregado);
+    pthread_cond_destroy(&carregador->consumido);
+    free(carregador->tarefas);
+    free(carregador->estados);
+    free(carregador->erros);
+    free(carregador->threads);
+}
+
+unsigned short carregarTarefas(Tarefa tarefas[], unsigned short quantidadeProgramas){
+    char nomeArquivo[TAMANHO_NOME_ARQUIVO + sizeof(EXTENSAO_LPAS)];
+    NomePrograma nome;
+    ErroExecucao erro;
+
+    for(int i = 0; i < quantidadeProgramas; i++){
+        snprintf(nome, TAMANHO_NOME_ARQUIVO, "%s", tarefas[i].nome);
+        switch(carregarPrograma(nome, &tarefas[i], &erro)){
+            case CARGA_CONCLUIDA:
+                continue;
+            case CARGA_INVALIDA:
+                imprimirDadosErro(erro);
+                break;
+            default:
+                snprintf(nomeArquivo, sizeof(nomeArquivo), "%s%s", tarefas[i].nome, EXTENSAO_LPAS);
+                printf(ERRO_PROGRAMA_NAO_EXISTE, nomeArquivo);
         }
+        tarefas[i--] = tarefas[--quantidadeProgramas]; // Substitui o programa não carregado pelo último do vetor.
     }
 
     return quantidadeProgramas;
 }
 
-void executarProgramas(Tarefa tarefas[], unsigned short quantidadeProgramas){
+unsigned long long calcularHashFonte(Programa *programa){
+    unsigned long long hash = 14695981039346656037ULL; // FNV-1a de 64 bits.
+
+    // O nome não entra no hash: programas com nomes diferentes e o mesmo texto compartilham a imagem.
+    for(unsigned short i = 0; i < programa->numeroDeInstrucoes; i++){
+        for(const char *c = programa->instrucoes[i]; *c; c++)
+            hash = (hash ^ (unsigned char) *c) * 1099511628211ULL;
+        hash = (hash ^ '\n') * 1099511628211ULL;
+        hash = (hash ^ (programa->linhas[i] & 0xFF)) * 1099511628211ULL;
+        hash = (hash ^ (programa->linhas[i] >> 8)) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+int compararFontes(Programa *programa, Programa *outro){
+    if(programa->numeroDeInstrucoes != outro->numeroDeInstrucoes)
+        return FALSE;
+
+    for(unsigned short i = 0; i < programa->numeroDeInstrucoes; i++)
+        if(programa->linhas[i] != outro->linhas[i] || strcmp(programa->instrucoes[i], outro->instrucoes[i]))
+            return FALSE;
+
+    return TRUE;
+}
+
+ImagemPrograma * procurarImagemPrograma(Programa *programa, unsigned long long hash){
+    for(ImagemPrograma *imagem = indiceImagens.baldes[hash % BALDES_IMAGENS]; imagem; imagem = imagem->proxima)
+        if(imagem->hash == hash && compararFontes(&imagem->programa, programa))
+            return imagem;
+
+    return NULL;
+}
+
+ImagemPrograma * obterImagemPrograma(Programa *programa, ErroExecucao *erro){
+    unsigned long long hash = calcularHashFonte(programa);
+    ImagemPrograma *imagem, *existente;
+
+    pthread_mutex_lock(&indiceImagens.trava);
+    if((imagem = procurarImagemPrograma(programa, hash)))
+        imagem->referencias++;
+    pthread_mutex_unlock(&indiceImagens.trava);
+    if(imagem)
+        return imagem;
+
+    // Primeira carga deste texto: a imagem é verificada e compilada fora da trava.
+    if(!(imagem = malloc(sizeof(ImagemPrograma)))){
+        printf(ERRO_MEMORIA_INSUFICIENTE);
+        exit(EXIT_FAILURE);
+    }
+    memcpy(&imagem->programa, programa, sizeof(Programa));
+    if(decodificarPrograma(&imagem->programa, &imagem->codigo, erro) != EXECUCAO_BEM_SUCEDIDA){
+        free(imagem);
+        return NULL;
+    }
+    if(configuracao.diretorioNativo)
+        compilarProgramaNativo(&imagem->codigo, imagem->programa.nome);
+    imagem->hash = hash;
+    imagem->referencias = 1;
+
+    // Outra thread pode ter publicado o mesmo texto enquanto esta verificava: a imagem publicada é mantida.
+    pthread_mutex_lock(&indiceImagens.trava);
+    if((existente = procurarImagemPrograma(programa, hash))){
+        existente->referencias++;
+    } else {
+        imagem->proxima = indiceImagens.baldes[hash % BALDES_IMAGENS];
+        indiceImagens.baldes[hash % BALDES_IMAGENS] = imagem;
+        indiceImagens.quantidadeImagens++;
+    }
+    pthread_mutex_unlock(&indiceImagens.trava);
+
+    if(existente){
+        free(imagem);
+        return existente;
+    }
+    return imagem;
+}
+
+void liberarImagemPrograma(ImagemPrograma *imagem){
+    ImagemPrograma **anterior;
+
+    if(!imagem)
+        return;
+
+    pthread_mutex_lock(&indiceImagens.trava);
+    if(--imagem->referencias > 0){
+        pthread_mutex_unlock(&indiceImagens.trava);
+        return;
+    }
+    for(anterior = &indiceImagens.baldes[imagem->hash % BALDES_IMAGENS]; *anterior != imagem; anterior = &(*anterior)->proxima);
+    *anterior = imagem->proxima;
+    indiceImagens.quantidadeImagens--;
+    pthread_mutex_unlock(&indiceImagens.trava);
+
+    free(imagem);
+}
+
+int possuiLeituraInterativa(Tarefa tarefas[], unsigned short quantidadeProgramas){
+    for(int i = 0; i < quantidadeProgramas; i++)
+        if(!tarefas[i].entradas && tarefas[i].imagem->codigo.quantidadeLeituras > 0){
+            printf(ERRO_MIGRACAO_LEITURA, tarefas[i].nome);
+            return TRUE;
+        }
+
+    return FALSE;
+}
+
+void executarProgramas(Tarefa tarefas[], unsigned short quantidadeProgramas, HistogramasLatencia *latenciasGlobais){
     unsigned short controle = 0, contadorProgramas = 0, quantidade, tes = 1;
-    Tarefa tarefasParaExecutar[NUMERO_MAXIMO_DE_PROGRAMAS];
+    QuadroMigracao *quadro = NULL;
+    pid_t processos[NUMERO_MAXIMO_DE_PROCESSOS], pid;
     int status;
 
+    // A consulta é feita antes da criação dos processos: uma tarefa migrada continua memoizada no processo que a recebe.
+    if(cacheResultados)
+        consultarMemoizacaoTarefas(tarefas, quantidadeProgramas);
+
+    /* Com a migração habilitada os processos executam simultaneamente, coordenados pelo processo pai. Processos simultâneos
+       disputariam o teclado: um grupo com READ interativo é executado sem migração, um processo por vez. */
+    if(configuracao.migracao && !possuiLeituraInterativa(tarefas, quantidadeProgramas))
+        quadro = criarQuadroMigracao((quantidadeProgramas + MAX_PROGRAMAS_PROCESSO - 1) / MAX_PROGRAMAS_PROCESSO);
+
     while(controle < quantidadeProgramas){
-        for(quantidade = 0; contadorProgramas < quantidadeProgramas && quantidade < MAX_PROGRAMAS_PROCESSO; contadorProgramas++, quantidade++)
-            tarefasParaExecutar[quantidade] = tarefas[contadorProgramas];
+        // As tarefas de cada processo são consecutivas no vetor, que é herdado pelo processo filho sem cópias adicionais.
+        quantidade = (quantidadeProgramas - contadorProgramas < MAX_PROGRAMAS_PROCESSO) ? quantidadeProgramas - contadorProgramas : MAX_PROGRAMAS_PROCESSO;
 
-        if(criarProcesso() != 0)
-            wait(&status);
-        else
-            executarEscalonarTarefas(tarefasParaExecutar, quantidade, tes);
+        // Sem o processo as tarefas do grupo não são executadas, mas os demais grupos continuam.
+        if((pid = criarProcesso()) < 0)
+            printf(ERRO_CRIAR_PROCESSO, tes, strerror(errno));
+
+        if(pid == 0)
+            executarEscalonarTarefas(&tarefas[contadorProgramas], quantidade, tes, quadro, latenciasGlobais);
+        else if(quadro)
+            processos[tes - 1] = (pid > 0) ? pid : 0;
+        else if(pid > 0)
+            waitpid(pid, &status, 0); // Somente o processo tes: os compiladores (--aot) das threads de carga também são filhos deste processo.
 
         tes++;
+        contadorProgramas += quantidade;
         controle += MAX_PROGRAMAS_PROCESSO;
     }
+
+    if(quadro){
+        coordenarMigracoes(quadro, processos, quadro->numeroDeProcessos);
+        destruirQuadroMigracao(quadro);
+    }
 }
 
-void executarEscalonarTarefas(Tarefa tarefas[MAX_PROGRAMAS_PROCESSO], unsigned short quantidadeProgramas, unsigned short tes){
+void executarEscalonarTarefas(Tarefa tarefas[], unsigned short quantidadeProgramas, unsigned short tes, QuadroMigracao *quadro, HistogramasLatencia *latenciasGlobais){
     MaquinaExecucao maquina;
     RoundRobin roudRobin;
+    HistogramasLatencia latencias;
     unsigned short indexFila = 0;
-    int index, resultado;
+    int index, resultado, outraPronta, despachada;
+    UnidadeTempo limite, executadas, avanco;
+    FuncaoNativa nativo;
+    unsigned lote;
+    int medirContadores;
+    unsigned long long leituraContadores[QUANTIDADE_CONTADORES];
+    unsigned short tarefaRajada = 0;
+    unsigned char pcRajada = 0;
 
     inicializarMaquinaExecucao(tarefas, quantidadeProgramas, &maquina);
     inicializarContextos(quantidadeProgramas, &maquina);
     roudRobin.contadorCPU = 0;
     roudRobin.contadorPreempcao = 1;
-
-    // Loop que representa o ciclo do processador: 1 volta no loop equivale à 1 UT.
+    roudRobin.migracoesEnviadas = roudRobin.migracoesRecebidas = 0;
+    roudRobin.custoMigracaoNs = roudRobin.esperaMigracaoNs = 0;
+    roudRobin.tempoOcioso = 0;
+    memset(roudRobin.tempoAnterior, 0, sizeof(roudRobin.tempoAnterior));
+    roudRobin.iteracoes = 0;
+    maquina.latenciaES = configuracao.latenciaES;
+
+    if(configuracao.afinidade)
+        aplicarAfinidade(deslocamentoAfinidade + tes - 1);
+
+    // O grupo de contadores é aberto no próprio processo tes (os contadores medem somente a thread que os abre).
+    memset(roudRobin.contadores, 0, sizeof(roudRobin.contadores));
+    memset(&roudRobin.contadoresEscalonador, 0, sizeof(ContadoresHardware));
+    roudRobin.grupoContadores.descritores[CONTADOR_CICLOS] = -1;
+    if(configuracao.contadores && abrirContadoresHardware(&roudRobin.grupoContadores) && !lerContadoresHardware(&roudRobin.grupoContadores, leituraContadores))
+        fecharContadoresHardware(&roudRobin.grupoContadores);
+    medirContadores = roudRobin.grupoContadores.descritores[CONTADOR_CICLOS] >= 0;
+
+    // O buffer de eventos é alocado antes do loop, para que o registro não aloque memória durante a execução.
+    roudRobin.eventos.total = 0;
+    roudRobin.eventos.eventos = (configuracao.prefixoTrace || configuracao.gantt) ? malloc(CAPACIDADE_REGISTRO_EVENTOS * sizeof(EventoEscalonador)) : NULL;
+
+    /* Loop que representa o ciclo do processador: 1 volta no loop equivale à 1 UT.
+       No avanço por eventos (--eventos), uma volta executa a tarefa até o próximo evento (chegada, fim de E/S, fim do quantum, término ou READ)
+       e, com todas as tarefas suspensas, o relógio salta direto para o fim da próxima E/S. A contabilização das ut é a mesma nos dois modos. */
     while(TRUE){
-        // Carregando novas tarefas para o estado PRONTA.
-        index = verificarEstadoTarefas(maquina.df, maquina.numeroDeProgramas, NOVA);
+        roudRobin.iteracoes++;
+
+        // Tarefas cuja E/S terminou voltam para a fila.
+        if(maquina.latenciaES)
+            despertarTarefas(&maquina, &roudRobin);
+
+        // Carregando novas tarefas, cujo instante de chegada foi alcançado, para o estado PRONTA.
+        index = verificarChegadas(&maquina, roudRobin.contadorCPU);
         if(index != NAO_ENCONTRADO) {
             maquina.df[index].estado = PRONTA; // Altera o estado da tarefa.
-            roudRobin.tempoEntradaESaidaFila[index][0] = roudRobin.contadorCPU; // Salva a UT do momento que a tarefa entrou na fila da CPU.
+            roudRobin.admissao[index] = roudRobin.contadorCPU;  // Salva a UT do momento que a tarefa entrou na fila da CPU.
+            roudRobin.tempoEntradaESaidaFila[index][0] = maquina.df[index].tarefa->chegada ? maquina.df[index].tarefa->chegada : roudRobin.contadorCPU;
+            registrarEvento(&roudRobin.eventos, EVENTO_ESTADO, index, NOVA, PRONTA, roudRobin.contadorCPU, 0);
+            medirTransicao(&roudRobin, index, NOVA, PRONTA);
+
+            // O prazo de tempo de relógio é contado a partir da admissão; o limite de variáveis é verificado uma única vez.
+            if(configuracao.limiteTempoMs)
+                maquina.df[index].prazoNs = obterTempoNs() + configuracao.limiteTempoMs * 1000000LL;
+            if(configuracao.limiteVariaveis && maquina.df[index].quantidadeVariaveis > configuracao.limiteVariaveis)
+                abortarTarefa(&maquina, &roudRobin, index);
         }
 
-        // Verifica se há tarefas aptas à serem escalonadas (estado diferente de TERMINADA);
-        if(!haTarefasAptas(maquina.df, maquina.numeroDeProgramas))
+        // Publica a carga e atende um eventual pedido de migração do coordenador.
+        if(quadro)
+            atenderPedidoMigracao(quadro, tes - 1, &maquina, &roudRobin, indexFila);
+
+        // Verifica se há tarefas aptas à serem escalonadas (estado diferente de TERMINADA), ou se alguma tarefa foi migrada para este processo.
+        if(!haTarefasAptas(maquina.df, maquina.numeroDeProgramas) && !(quadro && aguardarMigracao(quadro, tes - 1, &maquina, &roudRobin)))
             break;
 
-        // Escalona a próxima tarefa da fila, caso a tarefa executada anteriormente tenha terminado ou sofrido preempção.
-        if(maquina.df[indexFila].estado != EXECUTANDO)
+        // Escalona a próxima tarefa da fila, caso a tarefa executada anteriormente tenha terminado, sofrido preempção ou sido suspensa.
+        despachada = FALSE;
+        if(maquina.df[indexFila].estado != EXECUTANDO){
             escalonarProximaTarefaDaFila(&maquina, &indexFila);
+            despachada = TRUE;
+
+            // Todas as tarefas estão suspensas: a CPU fica ociosa até o fim da próxima E/S.
+            if(maquina.df[indexFila].estado != EXECUTANDO){
+                avanco = configuracao.eventos ? calcularProximoEvento(&maquina, &roudRobin, roudRobin.contadorCPU + LATENCIA_ES_MAXIMA) - roudRobin.contadorCPU : UT;
+                roudRobin.tempoOcioso += avanco;
+                roudRobin.contadorCPU += avanco;
+                continue;
+            }
+
+            registrarEvento(&roudRobin.eventos, EVENTO_ESTADO, indexFila, PRONTA, EXECUTANDO, roudRobin.contadorCPU, 0);
+            medirTransicao(&roudRobin, indexFila, PRONTA, EXECUTANDO);
+        }
 
-        // Interpreta e executa a instrução.
-        resultado = interpretador(indexFila, &maquina);
+        /* Quantidade de instruções executadas nesta volta. Nenhuma tarefa chega ou desperta antes do próximo evento, portanto a existência de
+           outra tarefa PRONTA (que decide a preempção) não muda durante a volta. Com migração, a volta é limitada a 1 quantum para que os
+           pedidos do coordenador continuem sendo atendidos. */
+        limite = configuracao.eventos ? calcularProximoEvento(&maquina, &roudRobin, quadro ? roudRobin.contadorCPU + QUANTUM : UINT_MAX) - roudRobin.contadorCPU : UT;
+        outraPronta = verificarEstadoTarefas(maquina.df, maquina.numeroDeProgramas, PRONTA) != NAO_ENCONTRADO;
+        nativo = maquina.df[indexFila].tarefa->imagem->codigo.nativo;
+
+        // O trecho da volta até aqui é do escalonador; a execução a seguir é atribuída à tarefa escalonada.
+        if(medirContadores){
+            encerrarFaseContadores(&roudRobin.grupoContadores, &roudRobin.contadoresEscalonador, leituraContadores);
+            tarefaRajada = indexFila;
+            pcRajada = maquina.df[indexFila].pc;
+        }
 
-        // Verifica se ocorreu algum erro.
-        if(resultado == RETURN_ERRO)
-            imprimirDadosErro(maquina.erroExecucao);
-        
-        // Incrementa o tempo de CPU da tarefa
-        maquina.df[indexFila].tempoCPU++;
-
-        // Termina a tarefa, caso a instrução HALT seja executada ou ocorra algum erro.
-        if(resultado == RETURN_FIM || resultado == RETURN_ERRO)
-            terminarTarefa(&maquina, &roudRobin, indexFila);
-        else {
-            // Verifica se a preempção por tempo deve ocorrer e se há outra tarefa pronta (caso não tenha, a preempção não ocorre, pois existe somente uma tarefa sendo executada)
-            if(roudRobin.contadorPreempcao >= QUANTUM && verificarEstadoTarefas(maquina.df, maquina.numeroDeProgramas, PRONTA) != NAO_ENCONTRADO) // 
-                gerarPreempcaoPorTempo(&maquina, &roudRobin, &indexFila);
-            else
-                roudRobin.contadorPreempcao++;
+        // Uma tarefa memoizada não é interpretada: o resultado guardado no cache é servido no seu primeiro escalonamento.
+        if(maquina.df[indexFila].tarefa->memoizada && maquina.df[indexFila].tempoCPU == 0)
+            servirTarefaMemoizada(&maquina.df[indexFila]);
+
+        for(executadas = 0; executadas < limite && maquina.df[indexFila].estado == EXECUTANDO; executadas++){
+            /* O código nativo e os ciclos pendentes (de uma instrução de vetor ou de uma tarefa memoizada) são executados em bloco até o
+               próximo evento: as ut anteriores à última são contabilizadas de uma vez, e a última segue o mesmo caminho de uma instrução
+               interpretada. Nas instruções que o código nativo não executa (lote 0), a instrução é interpretada. */
+            lote = 0;
+            if(maquina.df[indexFila].ciclosPendentes){
+                lote = calcularLoteInstrucoes(&roudRobin, &maquina.df[indexFila], limite - executadas, outraPronta, despachada && executadas == 0);
+                if(lote > maquina.df[indexFila].ciclosPendentes)
+                    lote = maquina.df[indexFila].ciclosPendentes;
+                maquina.df[indexFila].ciclosPendentes -= lote;
+            } else if(nativo){
+                lote = calcularLoteInstrucoes(&roudRobin, &maquina.df[indexFila], limite - executadas, outraPronta, despachada && executadas == 0);
+                lote = nativo(&maquina.registrador, maquina.variaveis, &maquina.df[indexFila].pc, lote);
+            }
+            if(lote > 0){
+                maquina.df[indexFila].tempoCPU += lote - 1;
+                roudRobin.contadorPreempcao += lote - 1;
+                roudRobin.contadorCPU += lote - 1;
+                executadas += lote - 1;
+                resultado = RETURN_OK;
+            } else // Interpreta e executa a instrução.
+                resultado = interpretador(indexFila, &maquina);
+
+            // Verifica se ocorreu algum erro.
+            if(resultado == RETURN_ERRO){
+                imprimirDadosErro(maquina.erroExecucao);
+                registrarEvento(&roudRobin.eventos, EVENTO_ERRO, indexFila, EXECUTANDO, EXECUTANDO, roudRobin.contadorCPU, maquina.erroExecucao.erro);
+            }
+            
+            // Incrementa o tempo de CPU da tarefa
+            maquina.df[indexFila].tempoCPU++;
+
+            // Watchdog: a tarefa que não terminou e excedeu o seu limite de CPU ou de tempo de relógio é abortada.
+            if(resultado != RETURN_FIM && resultado != RETURN_ERRO && (configuracao.limiteCPU || configuracao.limiteTempoMs)
+                && excedeuLimite(&maquina.df[indexFila], despachada && executadas == 0))
+                abortarTarefa(&maquina, &roudRobin, indexFila);
+            // Termina a tarefa, caso a instrução HALT seja executada ou ocorra algum erro.
+            else if(resultado == RETURN_FIM || resultado == RETURN_ERRO){
+                if(resultado == RETURN_FIM && cacheResultados && !maquina.df[indexFila].tarefa->memoizada)
+                    memoizarTarefa(&maquina.df[indexFila]);
+                terminarTarefa(&maquina, &roudRobin, indexFila);
+                registrarEvento(&roudRobin.eventos, EVENTO_ESTADO, indexFila, EXECUTANDO, TERMINADA, roudRobin.contadorCPU + 1, 0);
+            } else if(resultado == RETURN_ES){
+                // READ bloqueante: a tarefa libera a CPU até o fim da E/S.
+                registrarEvento(&roudRobin.eventos, EVENTO_ESTADO, indexFila, EXECUTANDO, SUSPENSA, roudRobin.contadorCPU + 1, 0);
+                suspenderTarefa(&maquina, &roudRobin, &indexFila);
+            } else {
+                // Verifica se a preempção por tempo deve ocorrer e se há outra tarefa pronta (caso não tenha, a preempção não ocorre, pois existe somente uma tarefa sendo executada)
+                if(roudRobin.contadorPreempcao >= QUANTUM && outraPronta){
+                    registrarEvento(&roudRobin.eventos, EVENTO_PREEMPCAO, indexFila, EXECUTANDO, PRONTA, roudRobin.contadorCPU + 1, 0);
+                    gerarPreempcaoPorTempo(&maquina, &roudRobin, &indexFila);
+                } else
+                    roudRobin.contadorPreempcao++;
+            }
+
+            // Incrementa a contagem de ut.
+            roudRobin.contadorCPU++;
         }
 
-        // Incrementa a contagem de ut.
-        roudRobin.contadorCPU++;
+        // A preempção ou o término trocam indexFila dentro do loop: a execução pertence à tarefa escalonada no início da volta.
+        if(medirContadores){
+            encerrarFaseContadores(&roudRobin.grupoContadores, &roudRobin.contadores[tarefaRajada], leituraContadores);
+            roudRobin.contadores[tarefaRajada].instrucoesLpas += (unsigned char) (maquina.df[tarefaRajada].pc - pcRajada);
+        }
     }
 
-    // Imprime o relatório
-    exibirRelatorioProcesso(maquina, roudRobin, quantidadeProgramas, tes);
+    if(medirContadores)
+        encerrarFaseContadores(&roudRobin.grupoContadores, &roudRobin.contadoresEscalonador, leituraContadores);
 
-    exit(EXIT_SUCCESS);
-} // executarEscalonarTarefas()
+    // Imprime o relatório e acumula as latências deste processo na distribuição global.
+    memset(&latencias, 0, sizeof(HistogramasLatencia));
+    registrarLatencias(&maquina, &roudRobin, &latencias);
+    exibirRelatorioProcesso(maquina, roudRobin, maquina.numeroDeProgramas, tes, &latencias);
+    if(latenciasGlobais)
+        combinarHistogramas(latenciasGlobais, &latencias);
 
-int interpretador(unsigned short indiceTarefa, MaquinaExecucao *maquina) {
-    Instrucao instrucao, dado;
-    char* argumento;
-    int tipoInstrucao;
-    unsigned char *pc = &maquina->df[indiceTarefa].pc; // Salva o valor do PC.
-    
-    strcpy(instrucao, maquina->df[indiceTarefa].tarefa.programa.instrucoes[*pc]); // Obtém somente o comando LPAS, ignorando possíveis argumentos.
-    tipoInstrucao = identificarInstrucao(instrucao); // Identifica o tipo de instrução.
+    if(roudRobin.eventos.eventos){
+        if(configuracao.prefixoTrace && !exportarTraceChrome(&roudRobin.eventos, &maquina, tes, configuracao.prefixoTrace))
+            printf(ERRO_ARQUIVO_NAO_EXISTE, configuracao.prefixoTrace);
+        free(roudRobin.eventos.eventos);
+    }
+    fecharContadoresHardware(&roudRobin.grupoContadores);
 
-    if(*pc == maquina->df[indiceTarefa].tarefa.programa.numeroDeInstrucoes && tipoInstrucao != HALT) // Verifica se a última instrução é HALT.
-        tipoInstrucao = RETURN_ERRO;
-    
-    argumento = obterArgumento(instrucao); // Obtém o argumento da instrução.
+    encerrarProcessoFilho(EXIT_SUCCESS);
+} // executarEscalonarTarefas()
 
-    if(argumento)
-        strcpy(dado, argumento);
+int interpretador(unsigned short indiceTarefa, MaquinaExecucao *maquina) {
+    DescritorTarefa *descritor = &maquina->df[indiceTarefa];
 
-    (*pc)++; // Incrementa o PC.
+    // A instrução de vetor já foi executada: a ut é consumida sem avançar o pc, e a tarefa continua preemptível.
+    if(descritor->ciclosPendentes){
+        descritor->ciclosPendentes--;
+        return RETURN_OK;
+    }
 
-    return executarInstrucao(tipoInstrucao, dado, indiceTarefa, maquina);
+    // O programa foi verificado na carga: a instrução e o seu argumento já estão decodificados e são válidos.
+    return executarInstrucao(&descritor->instrucoes[descritor->pc++], indiceTarefa, maquina);
 }
 
-int executarInstrucao(int tipoInstrucao, Instrucao dado, unsigned short indiceTarefa, MaquinaExecucao *maquina) {
-    unsigned char pc = maquina->df[indiceTarefa].pc;
+int executarInstrucao(const InstrucaoDecodificada *instrucao, unsigned short indiceTarefa, MaquinaExecucao *maquina) {
+    DescritorTarefa *descritor = &maquina->df[indiceTarefa];
+    unsigned char pc = descritor->pc;
     int erro;
 
     // Chega o tipo da instrução e chama a função correspondente.
-    switch (tipoInstrucao) {
+    switch (instrucao->codigo) {
     case READ:
-        erro = lpasRead(dado, indiceTarefa, maquina);
+        erro = lpasRead(instrucao, indiceTarefa, maquina);
+        if(erro == EXECUCAO_BEM_SUCEDIDA && maquina->latenciaES)
+            return RETURN_ES;
         break;
     case WRITE:
-        erro = lpasWrite(dado, indiceTarefa, maquina);
+        erro = lpasWrite(instrucao, indiceTarefa, maquina);
         break;
     case LOAD:
-        erro = lpasLoad(dado, maquina);
+        erro = lpasLoad(instrucao, maquina);
         break;
     case ADD:
-        erro = lpasAdd(dado, maquina);
+        erro = lpasAdd(instrucao, maquina);
         break;
     case SUB:
-        erro = lpasSub(dado, maquina);
+        erro = lpasSub(instrucao, maquina);
         break;
     case MUL:
-        erro = lpasMul(dado, maquina);
+        erro = lpasMul(instrucao, maquina);
         break;
     case DIV:
-        erro = lpasDiv(dado, maquina);
+        erro = lpasDiv(instrucao, maquina);
         break;
     case STORE:
-        erro = lpasStore(dado, maquina);
+        erro = lpasStore(instrucao, maquina);
         break;
     case HALT:
-        erro = EXECUCAO_BEM_SUCEDIDA;
-        break;
-    default:
-        erro = INSTRUCAO_LPAS_INVALIDA;
-        break;
+        return RETURN_FIM;
+    default: // Instruções de vetor.
+        erro = executarInstrucaoVetor(instrucao, indiceTarefa, maquina);
+        if(erro == EXECUCAO_BEM_SUCEDIDA && instrucao->codigo == VREAD && maquina->latenciaES)
+            return RETURN_ES;
     }
 
-    maquina->erroExecucao = geradorDeErrosLpas(pc, maquina->df[indiceTarefa].tarefa.programa.instrucoes[pc - 1], maquina->df[indiceTarefa].tarefa.programa.nome, erro);
+    if(erro == EXECUCAO_BEM_SUCEDIDA)
+        return RETURN_OK;
+
+    // Os dados do erro só são montados quando ele ocorre.
+    maquina->erroExecucao = geradorDeErrosLpas(descritor->tarefa->imagem->programa.linhas[pc - 1], descritor->tarefa->imagem->programa.instrucoes[pc - 1], descritor->tarefa->nome, erro);
+    return RETURN_ERRO;
+}
 
-    if(tipoInstrucao == HALT)
-        return RETURN_FIM;
+int lpasRead(const InstrucaoDecodificada *instrucao, unsigned short indiceTarefa, MaquinaExecucao *maquina){
+    if(!maquina->lote.entradas && !maquina->df[indiceTarefa].tarefa->entradas)
+        printf("%s -> %s: ", maquina->df[indiceTarefa].tarefa->nome, INST_READ);
 
-    if(erro != EXECUCAO_BEM_SUCEDIDA)
-        return RETURN_ERRO;
-    else
-        return RETURN_OK;
+    if(!lerValorEntrada(indiceTarefa, maquina, &maquina->variaveis[instrucao->valor]))
+        return SIMBOLO_INVALIDO;
+
+    maquina->df[indiceTarefa].tempoES += maquina->latenciaES ? maquina->latenciaES : READ_TIME;
+
+    return EXECUCAO_BEM_SUCEDIDA;
 }
 
-int lpasRead(Instrucao dado, unsigned short indiceTarefa, MaquinaExecucao *maquina ){
-    int qtdeLida;
+int lerValorEntrada(unsigned short indiceTarefa, MaquinaExecucao *maquina, int *valor){
+    Tarefa *tarefa = maquina->df[indiceTarefa].tarefa;
 
-    if(stringVazia(dado))
-        return ARGUMENTO_INSTRUCAO_LPAS_AUSENTE;
+    if(maquina->lote.entradas){ // Fora do modo interativo o valor é obtido das entradas informadas.
+        if(maquina->lote.proximaEntrada >= maquina->lote.quantidadeEntradas)
+            return FALSE;
+        *valor = maquina->lote.entradas[maquina->lote.proximaEntrada++];
+        return TRUE;
+    }
 
-    if(atoi(dado))
-        return ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
+    if(tarefa->entradas){ // Os valores foram enviados junto com o programa (modo servidor).
+        if(tarefa->proximaEntrada >= tarefa->quantidadeEntradas)
+            return FALSE;
+        *valor = tarefa->entradas[tarefa->proximaEntrada++];
+        return TRUE;
+    }
 
-    printf("%s -> %s: ", maquina->df[indiceTarefa].tarefa.programa.nome, INST_READ);
-    qtdeLida = scanf("%d", &maquina->variaveis[maquina->quantidadeVariaveis++]);
+    return scanf("%d", valor) == 1;
+}
 
-    if(qtdeLida != 1)
-        return SIMBOLO_INVALIDO;
+int lpasWrite(const InstrucaoDecodificada *instrucao, unsigned short indiceTarefa, MaquinaExecucao *maquina){
+    int valor = obterValorOperando(instrucao, maquina);
+    ResultadoMemoizado *resultado = &maquina->df[indiceTarefa].tarefa->resultado;
 
-    strcpy(maquina->nomesVariaveis[maquina->quantidadeVariaveis - 1], dado);
-    maquina->df[indiceTarefa].tempoES += READ_TIME;
+    // As escritas são registradas para o cache; a contagem continua além do limite para que o resultado incompleto não seja guardado.
+    if(cacheResultados){
+        if(resultado->quantidadeEscritas < MAXIMO_ESCRITAS_MEMO)
+            resultado->escritas[resultado->quantidadeEscritas] = valor;
+        resultado->quantidadeEscritas++;
+    }
 
+    if(maquina->lote.linha)
+        fprintf(maquina->lote.saida, "%s[%lu] -> %s: %d\n", maquina->df[indiceTarefa].tarefa->nome, maquina->lote.linha, INST_WRITE, valor);
+    else
+        fprintf(maquina->lote.saida ? maquina->lote.saida : stdout, "%s -> %s: %d\n", maquina->df[indiceTarefa].tarefa->nome, INST_WRITE, valor);
     return EXECUCAO_BEM_SUCEDIDA;
 }
 
-int lpasWrite(Instrucao dado, unsigned short indiceTarefa, MaquinaExecucao *maquina){
-    int valor, erro;
-    erro = obterValorNumericoDoArgumento(dado, maquina, &valor);
-
-    if(erro != EXECUCAO_BEM_SUCEDIDA)
-        return erro;
+int lpasLoad(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina){
+    maquina->registrador = obterValorOperando(instrucao, maquina);
 
-    printf("%s -> %s: %d\n", maquina->df[indiceTarefa].tarefa.programa.nome, INST_WRITE, valor);
     return EXECUCAO_BEM_SUCEDIDA;
 }
 
-int lpasLoad(Instrucao dado, MaquinaExecucao *maquina){
-    int valor, erro;
+int lpasAdd(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina){
+    maquina->registrador += obterValorOperando(instrucao, maquina);
 
-    if(stringVazia(dado))
-        return ARGUMENTO_INSTRUCAO_LPAS_AUSENTE;
+    return EXECUCAO_BEM_SUCEDIDA;
+}
 
-    erro = obterValorNumericoDoArgumento(dado, maquina, &valor);
+int lpasSub(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina){
+    maquina->registrador -= obterValorOperando(instrucao, maquina);
 
-    if(erro != EXECUCAO_BEM_SUCEDIDA)
-        return erro;
+    return EXECUCAO_BEM_SUCEDIDA;
+}
 
-    maquina->registrador = valor;
+int lpasMul(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina){
+    maquina->registrador *= obterValorOperando(instrucao, maquina);
 
     return EXECUCAO_BEM_SUCEDIDA;
 }
 
-int lpasAdd(Instrucao dado, MaquinaExecucao *maquina){
-    int valor, erro;
-    erro = obterValorNumericoDoArgumento(dado, maquina, &valor);
+int lpasDiv(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina){
+    int valor = obterValorOperando(instrucao, maquina);
 
-    if(erro == EXECUCAO_BEM_SUCEDIDA)
-        maquina->registrador += valor;
+    if(valor == 0) // Verifica se houve divisão por 0.
+        return ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
 
-    return erro;
-}
+    maquina->registrador /= valor;
 
-int lpasSub(Instrucao dado, MaquinaExecucao *maquina){
-    int valor, erro;
-    erro = obterValorNumericoDoArgumento(dado, maquina, &valor);
+    return EXECUCAO_BEM_SUCEDIDA;
+}
 
-    if(erro == EXECUCAO_BEM_SUCEDIDA)
-        maquina->registrador -= valor;
+int lpasStore(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina){
+    // O endereço da variável foi reservado na carga do programa.
+    maquina->variaveis[instrucao->valor] = maquina->registrador;
 
-    return erro;
+    return EXECUCAO_BEM_SUCEDIDA;
 }
 
-int lpasMul(Instrucao dado, MaquinaExecucao *maquina){
-    int valor, erro;
-    erro = obterValorNumericoDoArgumento(dado, maquina, &valor);
+int executarInstrucaoVetor(const InstrucaoDecodificada *instrucao, unsigned short indiceTarefa, MaquinaExecucao *maquina){
+    DescritorTarefa *descritor = &maquina->df[indiceTarefa];
+    const OperandosVetor *vetor = &descritor->tarefa->imagem->codigo.operandosVetor[instrucao->valor];
+    int erro;
+
+    switch(instrucao->codigo){
+    case ARRAY:
+        erro = lpasArray(vetor, maquina);
+        break;
+    case VREAD:
+        erro = lpasVread(vetor, indiceTarefa, maquina);
+        break;
+    case VWRITE:
+        erro = lpasVwrite(vetor, indiceTarefa, maquina);
+        break;
+    case VSUM:
+    case VMIN:
+    case VMAX:
+        erro = lpasReducaoVetor(instrucao->codigo, vetor, maquina);
+        break;
+    default: // VADD, VSUB, VMUL e VDIV.
+        erro = lpasOperacaoVetor(instrucao->codigo, vetor, maquina);
+    }
 
+    // A instrução é executada na primeira ut do seu custo; as demais são consumidas pelo interpretador.
     if(erro == EXECUCAO_BEM_SUCEDIDA)
-        maquina->registrador *= valor;
+        descritor->ciclosPendentes = calcularCustoVetor(vetor->tamanho) - 1;
 
     return erro;
 }
 
-int lpasDiv(Instrucao dado, MaquinaExecucao *maquina){
-    int valor, erro;
-    erro = obterValorNumericoDoArgumento(dado, maquina, &valor);
-
-    if(erro == EXECUCAO_BEM_SUCEDIDA){
-        if(valor != 0) // Verifica se houve divisão por 0.
-            maquina->registrador /= valor;
-        else
-            erro = ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
-    }
+int lpasArray(const OperandosVetor *vetor, MaquinaExecucao *maquina){
+    memset(&maquina->variaveis[vetor->endereco], 0, vetor->tamanho * sizeof(int));
 
-    return erro;
+    return EXECUCAO_BEM_SUCEDIDA;
 }
 
-int lpasStore(Instrucao dado, MaquinaExecucao *maquina){
-    int index;
+int lpasVread(const OperandosVetor *vetor, unsigned short indiceTarefa, MaquinaExecucao *maquina){
+    if(!maquina->lote.entradas && !maquina->df[indiceTarefa].tarefa->entradas)
+        printf("%s -> %s: ", maquina->df[indiceTarefa].tarefa->nome, INST_VREAD);
 
-    // Verifica se a variável já existe e armazena o valor nela.
-    for(index = 0; index < maquina->quantidadeVariaveis; index++)
-        if(!strcmp(dado, maquina->nomesVariaveis[index])){
-            maquina->variaveis[index] = maquina->registrador;
-            return EXECUCAO_BEM_SUCEDIDA;
-        }
-    
-    // Caso não exista, cria a variável e associa o nome e o valor.
-    if(index < NUMERO_MAXIMO_DE_VARIAVEIS){
-        strcpy(maquina->nomesVariaveis[maquina->quantidadeVariaveis++], dado);
-        maquina->variaveis[index] = maquina->registrador;
-    } else
-        return ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
+    for(int i = 0; i < vetor->tamanho; i++)
+        if(!lerValorEntrada(indiceTarefa, maquina, &maquina->variaveis[vetor->endereco + i]))
+            return SIMBOLO_INVALIDO;
+
+    // O vetor é lido em uma única operação de E/S.
+    maquina->df[indiceTarefa].tempoES += maquina->latenciaES ? maquina->latenciaES : READ_TIME;
 
     return EXECUCAO_BEM_SUCEDIDA;
 }
 
-int buscarEnderecoVariavelUsandoNome(Instrucao dado, MaquinaExecucao *maquina){
-    for(int index = 0; index < maquina->quantidadeVariaveis; index++)
-        if(!strcmp(dado, maquina->nomesVariaveis[index]))
-            return index;
+int lpasVwrite(const OperandosVetor *vetor, unsigned short indiceTarefa, MaquinaExecucao *maquina){
+    FILE *saida = maquina->lote.saida ? maquina->lote.saida : stdout;
 
-    return NAO_ENCONTRADO;
+    if(maquina->lote.linha)
+        fprintf(saida, "%s[%lu] -> %s:", maquina->df[indiceTarefa].tarefa->nome, maquina->lote.linha, INST_VWRITE);
+    else
+        fprintf(saida, "%s -> %s:", maquina->df[indiceTarefa].tarefa->nome, INST_VWRITE);
+
+    for(int i = 0; i < vetor->tamanho; i++)
+        fprintf(saida, " %d", maquina->variaveis[vetor->endereco + i]);
+    fputc(EOL, saida);
+
+    return EXECUCAO_BEM_SUCEDIDA;
 }
 
-int obterValorNumericoDoArgumento(Instrucao dado, MaquinaExecucao *maquina, int *valor){
-    int endereco;
+int lpasOperacaoVetor(int codigo, const OperandosVetor *vetor, MaquinaExecucao *maquina){
+    int *destino = &maquina->variaveis[vetor->endereco];
+    const int *origem = (vetor->tipoOrigem == ARGUMENTO_VETOR) ? &maquina->variaveis[vetor->origem] : NULL;
+    int escalar = (vetor->tipoOrigem == ARGUMENTO_VARIAVEL) ? maquina->variaveis[vetor->origem] : vetor->origem;
 
-    *valor = atoi(dado);
-    if(!(*valor)){
-        endereco = buscarEnderecoVariavelUsandoNome(dado, maquina);
-        if(endereco != NAO_ENCONTRADO)
-            *valor = maquina->variaveis[endereco];
-        else
-            return ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
+    if(codigo != VDIV){
+        // VADD, VSUB e VMUL seguem a ordem de ADD, SUB e MUL.
+        kernelVetor(codigo - VADD + ADD, destino, origem, escalar, vetor->tamanho);
+        return EXECUCAO_BEM_SUCEDIDA;
     }
-    
+
+    // Os divisores são verificados antes da divisão: com um divisor 0 o vetor não é alterado.
+    for(int i = 0; i < vetor->tamanho; i++)
+        if((origem ? origem[i] : escalar) == 0)
+            return ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
+
+    dividirInstancias(destino, origem, escalar, vetor->tamanho, NULL, NULL, 0);
+    return EXECUCAO_BEM_SUCEDIDA;
+}
+
+int lpasReducaoVetor(int codigo, const OperandosVetor *vetor, MaquinaExecucao *maquina){
+    maquina->registrador = kernelReducao(codigo, &maquina->variaveis[vetor->endereco], vetor->tamanho);
+
     return EXECUCAO_BEM_SUCEDIDA;
 }
 
+int obterValorOperando(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina){
+    return (instrucao->tipoArgumento == ARGUMENTO_VARIAVEL) ? maquina->variaveis[instrucao->valor] : instrucao->valor;
+}
+
 char * obterArgumento(){
-    return strtok(NULL, DELIMITADOR);
+    return strtok_r(NULL, DELIMITADOR, &contextoInstrucao);
 }
 
 int identificarInstrucao(Instrucao instrucao){
     char *comando;
-    Instrucao comandosLPAS[] = {INST_READ, INST_WRITE, INST_LOAD, INST_STORE, INST_ADD, INST_SUB, INST_MUL, INST_DIV, INST_HALT};
-    int codigoInstrucao[] = {READ, WRITE, LOAD, STORE, ADD, SUB, MUL, DIV, HALT};
+    Instrucao comandosLPAS[] = {INST_READ, INST_WRITE, INST_LOAD, INST_STORE, INST_ADD, INST_SUB, INST_MUL, INST_DIV, INST_HALT,
+                                INST_ARRAY, INST_VREAD, INST_VWRITE, INST_VADD, INST_VSUB, INST_VMUL, INST_VDIV, INST_VSUM, INST_VMIN, INST_VMAX};
+    int codigoInstrucao[] = {READ, WRITE, LOAD, STORE, ADD, SUB, MUL, DIV, HALT, ARRAY, VREAD, VWRITE, VADD, VSUB, VMUL, VDIV, VSUM, VMIN, VMAX};
+
+    comando = strtok_r(instrucao, DELIMITADOR, &contextoInstrucao);
+    if(!comando) // Linha contendo apenas espaços.
+        return NAO_ENCONTRADO;
 
-    comando = strtok(instrucao, DELIMITADOR);
     for(int i = 0; i < QUANTIDADE_INST_LPAS; i++)
         if(!strcmp(comando, comandosLPAS[i]))
             return codigoInstrucao[i];
@@ -403,85 +1162,2060 @@ ErroExecucao geradorDeErrosLpas(unsigned short numeroLinha, Instrucao instrucao,
 }
 
 void inicializarMaquinaExecucao(Tarefa tarefas[], unsigned short quantidadeProgramas, MaquinaExecucao *maquina) {
+    memset(&maquina->lote, 0, sizeof(EntradaSaidaLote)); // Modo interativo: teclado e saída padrão.
+    maquina->latenciaES = 0;                                // READ não bloqueante.
     for(int index = 0; index < quantidadeProgramas; index++){
         tarefas[index].identificador = index + 1;           // Identificador da tarefa.
         maquina->numeroDeProgramas = quantidadeProgramas;   // Quantidade de programas.
         maquina->df[index].estado = NOVA;                   // Estado da tarefa.
         maquina->df[index].pc = 0;                          // Contador de Programa.
-        maquina->df[index].tarefa = tarefas[index];         // Tarefa.
+        maquina->df[index].ciclosPendentes = 0;             // Nenhuma instrução de vetor em execução.
+        maquina->df[index].tarefa = &tarefas[index];        // Tarefa (dados frios).
+        maquina->df[index].instrucoes = tarefas[index].imagem->codigo.instrucoes; // Memória de código.
         maquina->df[index].tempoCPU = 0;                    // Tempo de CPU.
         maquina->df[index].tempoES = 0;                     // Tempo de entrada e saída.
+        maquina->df[index].migrada = FALSE;                 // A tarefa pertence a este processo.
+        maquina->df[index].abortada = FALSE;                // Abortada pelo watchdog.
+        maquina->df[index].prazoNs = 0;                     // Sem prazo de tempo de relógio.
     }
 }
 
 void inicializarContextos(unsigned short quantidadeProgramas, MaquinaExecucao *maquina) {
     for(int index = 0; index < quantidadeProgramas; index++) {
         maquina->df[index].registrador = 0;
-        maquina->df[index].quantidadeVariaveis = 0;
+        maquina->df[index].quantidadeVariaveis = maquina->df[index].tarefa->imagem->codigo.quantidadeVariaveis; // Endereços reservados na carga.
+
+        // A memória de dados tem exatamente o número de variáveis do programa (+1 evita alocações de tamanho 0).
+        maquina->df[index].variaveis = malloc((maquina->df[index].quantidadeVariaveis + 1) * sizeof(int));
+        if(!maquina->df[index].variaveis){
+            printf(ERRO_MEMORIA_INSUFICIENTE);
+            exit(EXIT_FAILURE);
+        }
     }
 }
 
 void carregarContextoParaMaquina(unsigned short indexTarefa, MaquinaExecucao *maquina){
-    int i = 0;
     maquina->registrador = maquina->df[indexTarefa].registrador;
-    maquina->quantidadeVariaveis = maquina->df[indexTarefa].quantidadeVariaveis;
-    while(i < maquina->df[indexTarefa].quantidadeVariaveis){
-        maquina->variaveis[i] = maquina->df[indexTarefa].variaveis[i];
-        strcpy(maquina->nomesVariaveis[i], maquina->df[indexTarefa].nomesVariaveis[i]);
-        i++;
-    }
+    maquina->variaveis = maquina->df[indexTarefa].variaveis;
 }
 
 void salvarContextoDaMaquina(unsigned short indexTarefa, MaquinaExecucao *maquina){
-    int i = 0;
+    // As variáveis já estão na memória de dados da tarefa: somente o registrador precisa ser salvo.
     maquina->df[indexTarefa].registrador = maquina->registrador;
-    maquina->df[indexTarefa].quantidadeVariaveis = maquina->quantidadeVariaveis;
-    while(i < maquina->quantidadeVariaveis){
-        maquina->df[indexTarefa].variaveis[i] = maquina->variaveis[i];
-        strcpy(maquina->df[indexTarefa].nomesVariaveis[i], maquina->nomesVariaveis[i]);
-        i++;
+}
+
+unsigned calcularLoteInstrucoes(RoundRobin *roudRobin, DescritorTarefa *descritor, UnidadeTempo restantes, int outraPronta, int verificarRelogio){
+    unsigned lote = restantes, maximo;
+
+    // Com outra tarefa pronta, a instrução que completa o quantum é a última do bloco.
+    if(outraPronta){
+        maximo = (roudRobin->contadorPreempcao >= QUANTUM) ? 1 : QUANTUM + 1 - roudRobin->contadorPreempcao;
+        if(lote > maximo) lote = maximo;
+    }
+
+    // O watchdog verifica o limite de CPU a cada instrução e o relógio a cada INTERVALO_WATCHDOG instruções (ou no escalonamento).
+    if(configuracao.limiteCPU){
+        maximo = (descritor->tempoCPU >= configuracao.limiteCPU) ? 1 : configuracao.limiteCPU - descritor->tempoCPU;
+        if(lote > maximo) lote = maximo;
+    }
+    if(descritor->prazoNs){
+        maximo = verificarRelogio ? 1 : INTERVALO_WATCHDOG - (descritor->tempoCPU & (INTERVALO_WATCHDOG - 1));
+        if(lote > maximo) lote = maximo;
+    }
+
+    return lote ? lote : 1;
+}
+
+int verificarEstadoTarefas(DescritorTarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS], unsigned short quantidade, EstadoTarefa estado){
+    for(int index = 0; index < quantidade; index++)
+        if(tarefas[index].estado == estado)
+            return index;
+
+    return NAO_ENCONTRADO;
+}
+
+int verificarChegadas(MaquinaExecucao *maquina, UnidadeTempo agora){
+    for(int index = 0; index < maquina->numeroDeProgramas; index++)
+        if(maquina->df[index].estado == NOVA && maquina->df[index].tarefa->chegada <= agora)
+            return index;
+
+    return NAO_ENCONTRADO;
+}
+
+char * procurarSeparadorChegada(const char *nome){
+    char *separador = strrchr(nome, SEPARADOR_CHEGADA);
+
+    if(!separador || !separador[1] || strspn(separador + 1, "0123456789") != strlen(separador + 1))
+        return NULL;
+
+    return separador;
+}
+
+int separarChegada(char *nome, UnidadeTempo *chegada){
+    char *separador = procurarSeparadorChegada(nome);
+    int valor;
+
+    *chegada = 0;
+    if(!separador)
+        return TRUE;
+
+    if(!converterNumero(separador + 1, &valor) || valor > CHEGADA_MAXIMA)
+        return FALSE;
+
+    *separador = CHAR_NULO;
+    *chegada = valor;
+    return TRUE;
+}
+
+int haTarefasAptas(DescritorTarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS], unsigned short quantidade){
+    int cont = 0;
+    for(int index = 0; index < quantidade; index++)
+        if(tarefas[index].estado != TERMINADA)
+            cont++;
+
+    return (cont > 0) ? TRUE : FALSE;
+}
+
+void escalonarProximaTarefaDaFila(MaquinaExecucao *maquina, unsigned short *indexFila){
+    for(int i = 0; i < maquina->numeroDeProgramas; i++){
+        if(maquina->df[*indexFila].estado == PRONTA){
+            maquina->df[*indexFila].estado = EXECUTANDO;
+            carregarContextoParaMaquina(*indexFila, maquina);
+            break;
+        } else
+            if(++(*indexFila) == maquina->numeroDeProgramas) *indexFila = 0;
+    }
+}
+
+void gerarPreempcaoPorTempo(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short *indexFila){
+    maquina->df[*indexFila].estado = PRONTA;
+    medirTransicao(roudRobin, *indexFila, EXECUTANDO, PRONTA);
+    salvarContextoDaMaquina(*indexFila, maquina);
+    if(++(*indexFila) == maquina->numeroDeProgramas) *indexFila = 0;
+    roudRobin->contadorPreempcao = 1;
+}
+
+void terminarTarefa(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short indexFila){
+    maquina->df[indexFila].estado = TERMINADA;
+    medirTransicao(roudRobin, indexFila, EXECUTANDO, TERMINADA);
+    free(maquina->df[indexFila].variaveis);
+    maquina->df[indexFila].variaveis = NULL;
+    roudRobin->contadorPreempcao = 1;
+    roudRobin->tempoEntradaESaidaFila[indexFila][1] = roudRobin->contadorCPU + 1;
+}
+
+int excedeuLimite(DescritorTarefa *descritor, int verificarRelogio){
+    if(configuracao.limiteCPU && descritor->tempoCPU >= configuracao.limiteCPU)
+        return TRUE;
+
+    // A leitura do relógio é a parte cara da verificação: é feita somente no escalonamento da tarefa e a cada INTERVALO_WATCHDOG instruções.
+    if(descritor->prazoNs && (verificarRelogio || !(descritor->tempoCPU & (INTERVALO_WATCHDOG - 1))))
+        return obterTempoNs() > descritor->prazoNs;
+
+    return FALSE;
+}
+
+void abortarTarefa(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short index){
+    DescritorTarefa *descritor = &maquina->df[index];
+    unsigned char pc = descritor->pc ? descritor->pc - 1 : 0; // Última instrução executada (ou a primeira, caso nenhuma tenha sido executada).
+    int estadoAnterior = descritor->estado;
+
+    maquina->erroExecucao = geradorDeErrosLpas(descritor->tarefa->imagem->programa.linhas[pc], descritor->tarefa->imagem->programa.instrucoes[pc], descritor->tarefa->nome, LIMITE_EXCEDIDO);
+    imprimirDadosErro(maquina->erroExecucao);
+    registrarEvento(&roudRobin->eventos, EVENTO_ERRO, index, estadoAnterior, estadoAnterior, roudRobin->contadorCPU, LIMITE_EXCEDIDO);
+    descritor->abortada = TRUE;
+
+    if(estadoAnterior == EXECUTANDO){
+        // A instrução desta ut foi executada: a tarefa sai da fila ao final da ut, como no término normal.
+        terminarTarefa(maquina, roudRobin, index);
+        registrarEvento(&roudRobin->eventos, EVENTO_ESTADO, index, EXECUTANDO, TERMINADA, roudRobin->contadorCPU + 1, 0);
+    } else {
+        // A tarefa ainda não executou nesta ut e não interrompe a contagem do quantum da tarefa em execução.
+        descritor->estado = TERMINADA;
+        medirTransicao(roudRobin, index, estadoAnterior, TERMINADA);
+        free(descritor->variaveis);
+        descritor->variaveis = NULL;
+        roudRobin->tempoEntradaESaidaFila[index][1] = roudRobin->contadorCPU;
+        registrarEvento(&roudRobin->eventos, EVENTO_ESTADO, index, estadoAnterior, TERMINADA, roudRobin->contadorCPU, 0);
+    }
+}
+
+void suspenderTarefa(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short *indexFila){
+    maquina->df[*indexFila].estado = SUSPENSA;
+    maquina->df[*indexFila].fimES = roudRobin->contadorCPU + 1 + maquina->latenciaES;
+    salvarContextoDaMaquina(*indexFila, maquina);
+    if(++(*indexFila) == maquina->numeroDeProgramas) *indexFila = 0;
+    roudRobin->contadorPreempcao = 1;
+}
+
+void despertarTarefas(MaquinaExecucao *maquina, RoundRobin *roudRobin){
+    for(int index = 0; index < maquina->numeroDeProgramas; index++)
+        if(maquina->df[index].estado == SUSPENSA && maquina->df[index].fimES <= roudRobin->contadorCPU){
+            maquina->df[index].estado = PRONTA;
+            registrarEvento(&roudRobin->eventos, EVENTO_ESTADO, index, SUSPENSA, PRONTA, maquina->df[index].fimES, 0);
+            medirTransicao(roudRobin, index, SUSPENSA, PRONTA);
+        }
+}
+
+UnidadeTempo calcularProximoEvento(MaquinaExecucao *maquina, RoundRobin *roudRobin, UnidadeTempo limite){
+    UnidadeTempo proximo = limite;
+
+    for(int index = 0; index < maquina->numeroDeProgramas; index++){
+        // Uma tarefa NOVA que já chegou é admitida por ut.
+        if(maquina->df[index].estado == NOVA){
+            if(maquina->df[index].tarefa->chegada <= roudRobin->contadorCPU)
+                return roudRobin->contadorCPU + UT;
+            if(maquina->df[index].tarefa->chegada < proximo)
+                proximo = maquina->df[index].tarefa->chegada;
+        }
+
+        if(maquina->df[index].estado == SUSPENSA && maquina->df[index].fimES < proximo)
+            proximo = maquina->df[index].fimES;
+    }
+
+    // Garante o avanço de pelo menos 1 ut.
+    return (proximo > roudRobin->contadorCPU) ? proximo : roudRobin->contadorCPU + UT;
+}
+
+void medirTransicao(RoundRobin *roudRobin, unsigned short index, int estadoAnterior, int estadoNovo){
+    MedidasTarefa *medidas = &roudRobin->medidas[index];
+    long long agora = obterTempoNs();
+
+    if(estadoAnterior == NOVA){
+        memset(medidas, 0, sizeof(MedidasTarefa));
+        medidas->chegadaNs = agora;
+    }
+
+    // O tempo no estado PRONTA é o tempo de espera da tarefa.
+    if(estadoAnterior == PRONTA)
+        medidas->esperaNs += agora - medidas->prontaDesdeNs;
+
+    if(estadoNovo == PRONTA)
+        medidas->prontaDesdeNs = agora;
+    else if(estadoNovo == EXECUTANDO && !medidas->despachada){
+        medidas->despachada = TRUE;
+        medidas->respostaNs = agora - medidas->chegadaNs;
+        medidas->respostaUt = roudRobin->contadorCPU - roudRobin->tempoEntradaESaidaFila[index][0];
+    } else if(estadoNovo == TERMINADA)
+        medidas->saidaNs = agora;
+}
+
+UnidadeTempo calcularTempoEspera(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short index){
+    UnidadeTempo execucao = roudRobin->tempoEntradaESaidaFila[index][1] - roudRobin->tempoEntradaESaidaFila[index][0];
+    UnidadeTempo ocupado = maquina->df[index].tempoCPU - roudRobin->tempoAnterior[index][0];
+
+    // Com E/S bloqueante, o tempo suspenso não é tempo de espera na fila.
+    if(maquina->latenciaES)
+        ocupado += maquina->df[index].tempoES - roudRobin->tempoAnterior[index][1];
+
+    return (execucao > ocupado) ? execucao - ocupado : 0;
+}
+
+void registrarLatencias(MaquinaExecucao *maquina, RoundRobin *roudRobin, HistogramasLatencia *latencias){
+    MedidasTarefa *medidas;
+    UnidadeTempo execucao;
+
+    for(int index = 0; index < maquina->numeroDeProgramas; index++){
+        if(maquina->df[index].migrada)
+            continue;
+
+        medidas = &roudRobin->medidas[index];
+        execucao = roudRobin->tempoEntradaESaidaFila[index][1] - roudRobin->tempoEntradaESaidaFila[index][0];
+
+        // Mesmas definições dos tempos médios do relatório.
+        registrarValorHistograma(&latencias->ut[LATENCIA_EXECUCAO], execucao);
+        registrarValorHistograma(&latencias->ut[LATENCIA_ESPERA], calcularTempoEspera(maquina, roudRobin, index));
+        registrarValorHistograma(&latencias->ns[LATENCIA_EXECUCAO], medidas->saidaNs - medidas->chegadaNs);
+        registrarValorHistograma(&latencias->ns[LATENCIA_ESPERA], medidas->esperaNs);
+
+        // Uma tarefa abortada antes de ser escalonada não tem tempo de resposta.
+        if(medidas->despachada){
+            registrarValorHistograma(&latencias->ut[LATENCIA_RESPOSTA], medidas->respostaUt);
+            registrarValorHistograma(&latencias->ns[LATENCIA_RESPOSTA], medidas->respostaNs);
+        }
+    }
+}
+
+int indiceFaixaHistograma(unsigned long long valor){
+    int expoente;
+
+    if(valor < SUBFAIXAS_HISTOGRAMA)
+        return valor;
+
+    // Os BITS_SUBFAIXAS_HISTOGRAMA bits seguintes ao bit mais significativo escolhem a subfaixa da potência de 2.
+    expoente = 63 - __builtin_clzll(valor);
+    return ((expoente - BITS_SUBFAIXAS_HISTOGRAMA + 1) << BITS_SUBFAIXAS_HISTOGRAMA) + ((valor >> (expoente - BITS_SUBFAIXAS_HISTOGRAMA)) & (SUBFAIXAS_HISTOGRAMA - 1));
+}
+
+unsigned long long limiteFaixaHistograma(int faixa){
+    int deslocamento;
+
+    if(faixa < SUBFAIXAS_HISTOGRAMA)
+        return faixa;
+
+    deslocamento = (faixa >> BITS_SUBFAIXAS_HISTOGRAMA) - 1;
+    return ((unsigned long long) (SUBFAIXAS_HISTOGRAMA + (faixa & (SUBFAIXAS_HISTOGRAMA - 1))) << deslocamento) + (1ULL << deslocamento) - 1;
+}
+
+void registrarValorHistograma(Histograma *histograma, unsigned long long valor){
+    histograma->contagem[indiceFaixaHistograma(valor)]++;
+    histograma->total++;
+    if(valor > histograma->maximo)
+        histograma->maximo = valor;
+}
+
+unsigned long long percentilHistograma(Histograma *histograma, double percentil){
+    unsigned long long alvo = (unsigned long long) (percentil * histograma->total + 0.999999), acumulado = 0, limite;
+
+    if(histograma->total == 0)
+        return 0;
+
+    for(int faixa = 0; faixa < FAIXAS_HISTOGRAMA; faixa++){
+        acumulado += histograma->contagem[faixa];
+        if(acumulado >= alvo){
+            limite = limiteFaixaHistograma(faixa);
+            return (limite < histograma->maximo) ? limite : histograma->maximo;
+        }
+    }
+
+    return histograma->maximo;
+}
+
+void combinarHistogramas(HistogramasLatencia *destino, HistogramasLatencia *origem){
+    Histograma *de[] = {origem->ut, origem->ns}, *para[] = {destino->ut, destino->ns};
+    unsigned long long maximo;
+
+    for(int unidade = 0; unidade < 2; unidade++)
+        for(int tipo = 0; tipo < QUANTIDADE_LATENCIAS; tipo++){
+            if(de[unidade][tipo].total == 0)
+                continue;
+
+            for(int faixa = 0; faixa < FAIXAS_HISTOGRAMA; faixa++)
+                if(de[unidade][tipo].contagem[faixa])
+                    __atomic_fetch_add(&para[unidade][tipo].contagem[faixa], de[unidade][tipo].contagem[faixa], __ATOMIC_RELAXED);
+            __atomic_fetch_add(&para[unidade][tipo].total, de[unidade][tipo].total, __ATOMIC_RELAXED);
+
+            maximo = __atomic_load_n(&para[unidade][tipo].maximo, __ATOMIC_RELAXED);
+            while(de[unidade][tipo].maximo > maximo
+                  && !__atomic_compare_exchange_n(&para[unidade][tipo].maximo, &maximo, de[unidade][tipo].maximo, FALSE, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+        }
+}
+
+void exibirLatencias(HistogramasLatencia *latencias){
+    // Os nomes são alinhados manualmente: printf conta bytes, e não caracteres acentuados.
+    const char *nomes[] = {"Execução ", "Espera   ", "Resposta "};
+    const double percentis[] = {0.50, 0.90, 0.99};
+
+    printf("\n\n\t- Latências %14s %10s %10s %11s", "p50", "p90", "p99", "máx");
+    for(int tipo = 0; tipo < QUANTIDADE_LATENCIAS; tipo++){
+        printf("\n\t%s(ut) ", nomes[tipo]);
+        for(int i = 0; i < 3; i++)
+            printf(" %10llu", percentilHistograma(&latencias->ut[tipo], percentis[i]));
+        printf(" %10llu", latencias->ut[tipo].maximo);
+    }
+    for(int tipo = 0; tipo < QUANTIDADE_LATENCIAS; tipo++){
+        printf("\n\t%s(us) ", nomes[tipo]);
+        for(int i = 0; i < 3; i++)
+            printf(" %10.1f", percentilHistograma(&latencias->ns[tipo], percentis[i]) / 1000.0);
+        printf(" %10.1f", latencias->ns[tipo].maximo / 1000.0);
+    }
+}
+
+void exibirLatenciasCombinadas(const char *titulo, HistogramasLatencia *latencias){
+    if(latencias->ut[LATENCIA_EXECUCAO].total == 0)
+        return;
+
+    printf("\n- %s (%llu tarefas)", titulo, latencias->ut[LATENCIA_EXECUCAO].total);
+    exibirLatencias(latencias);
+    printf("\n\n");
+}
+
+HistogramasLatencia * criarHistogramasCompartilhados(){
+    HistogramasLatencia *latencias = mmap(NULL, sizeof(HistogramasLatencia), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    // A memória anônima já é zerada pelo sistema.
+    return (latencias == MAP_FAILED) ? NULL : latencias;
+}
+
+void destruirHistogramasCompartilhados(HistogramasLatencia *latencias){
+    munmap(latencias, sizeof(HistogramasLatencia));
+}
+
+void registrarEvento(RegistroEventos *registro, TipoEvento tipo, unsigned short tarefa, int estadoAnterior, int estadoNovo, UnidadeTempo ut, int erro){
+    EventoEscalonador *evento;
+
+    if(!registro->eventos)
+        return;
+
+    // A capacidade é potência de 2: o índice circular é obtido com uma máscara.
+    evento = &registro->eventos[registro->total++ & (CAPACIDADE_REGISTRO_EVENTOS - 1)];
+    evento->tempoNs = obterTempoNs();
+    evento->ut = ut;
+    evento->tarefa = tarefa;
+    evento->tipo = tipo;
+    evento->estadoAnterior = estadoAnterior;
+    evento->estadoNovo = estadoNovo;
+    evento->erro = erro;
+}
+
+void escreverTextoJson(FILE *arquivo, const char *texto){
+    for(const unsigned char *c = (const unsigned char *) texto; *c; c++){
+        if(*c == '"' || *c == '\\')
+            fprintf(arquivo, "\\%c", *c);
+        else if(*c < 0x20)
+            fprintf(arquivo, "\\u%04x", *c);
+        else
+            fputc(*c, arquivo);
+    }
+}
+
+int exportarTraceChrome(RegistroEventos *registro, MaquinaExecucao *maquina, unsigned short tes, const char *prefixo){
+    const char *nomesEstados[] = {"NOVA", "PRONTA", "EXECUTANDO", "SUSPENSA", "TERMINADA"};
+    const char *nomesEventos[] = {"estado", "preempção", "erro", "migração"};
+    char nomeArquivo[TAMANHO_NOME_ARQUIVO * 2];
+    int estado[NUMERO_MAXIMO_DE_PROGRAMAS];
+    long long inicioEstadoNs[NUMERO_MAXIMO_DE_PROGRAMAS], origemNs;
+    UnidadeTempo inicioEstadoUt[NUMERO_MAXIMO_DE_PROGRAMAS];
+    unsigned long long primeiro = (registro->total > CAPACIDADE_REGISTRO_EVENTOS) ? registro->total - CAPACIDADE_REGISTRO_EVENTOS : 0;
+    EventoEscalonador *evento;
+    FILE *arquivo;
+
+    snprintf(nomeArquivo, sizeof(nomeArquivo), "%s.tes%d.json", prefixo, tes);
+    if(!(arquivo = fopen(nomeArquivo, "w")))
+        return FALSE;
+
+    origemNs = (registro->total > 0) ? registro->eventos[primeiro & (CAPACIDADE_REGISTRO_EVENTOS - 1)].tempoNs : 0;
+
+    // Metadados: nome do processo e uma "thread" por tarefa.
+    fprintf(arquivo, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(arquivo, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"tes%d\"}}", tes, tes);
+    for(int i = 0; i < maquina->numeroDeProgramas; i++){
+        fprintf(arquivo, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"", tes, i + 1);
+        escreverTextoJson(arquivo, maquina->df[i].tarefa->nome); // O nome vem do usuário (ou de um caminho) e pode conter aspas.
+        fprintf(arquivo, "%s\"}}", EXTENSAO_LPAS);
+        estado[i] = NOVA;
+    }
+
+    for(unsigned long long i = primeiro; i < registro->total; i++){
+        evento = &registro->eventos[i & (CAPACIDADE_REGISTRO_EVENTOS - 1)];
+
+        if(evento->tipo != EVENTO_ESTADO)
+            fprintf(arquivo, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"args\":{\"ut\":%d,\"erro\":%d}}",
+                    nomesEventos[evento->tipo], tes, evento->tarefa + 1, (evento->tempoNs - origemNs) / 1000.0, evento->ut, evento->erro);
+
+        if(evento->estadoAnterior == evento->estadoNovo)
+            continue;
+
+        // Fecha o intervalo do estado anterior da tarefa (NOVA e TERMINADA não são exibidos).
+        if(estado[evento->tarefa] != NOVA && estado[evento->tarefa] != TERMINADA)
+            fprintf(arquivo, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"ut_inicio\":%d,\"ut_fim\":%d}}",
+                    nomesEstados[estado[evento->tarefa]], tes, evento->tarefa + 1, (inicioEstadoNs[evento->tarefa] - origemNs) / 1000.0,
+                    (evento->tempoNs - inicioEstadoNs[evento->tarefa]) / 1000.0, inicioEstadoUt[evento->tarefa], evento->ut);
+
+        estado[evento->tarefa] = evento->estadoNovo;
+        inicioEstadoNs[evento->tarefa] = evento->tempoNs;
+        inicioEstadoUt[evento->tarefa] = evento->ut;
+    }
+
+    fprintf(arquivo, "\n]}\n");
+    fclose(arquivo);
+
+    return TRUE;
+}
+
+void exibirGantt(RegistroEventos *registro, MaquinaExecucao *maquina, UnidadeTempo totalUt){
+    const char simbolosEstados[] = {' ', '.', '#', 's', ' '};
+    char *linhas[NUMERO_MAXIMO_DE_PROGRAMAS];
+    int estado[NUMERO_MAXIMO_DE_PROGRAMAS];
+    UnidadeTempo inicio[NUMERO_MAXIMO_DE_PROGRAMAS], inicioGrafico = 0, escala, colunas;
+    unsigned long long primeiro = (registro->total > CAPACIDADE_REGISTRO_EVENTOS) ? registro->total - CAPACIDADE_REGISTRO_EVENTOS : 0;
+    EventoEscalonador *evento;
+
+    /* Com o registro circular cheio, os eventos mais antigos foram sobrescritos: o diagrama começa no primeiro evento guardado, e o
+       estado de cada tarefa é desconhecido até o seu primeiro evento guardado. */
+    if(primeiro > 0)
+        inicioGrafico = registro->eventos[primeiro & (CAPACIDADE_REGISTRO_EVENTOS - 1)].ut;
+    if(inicioGrafico >= totalUt)
+        return;
+
+    // Execuções longas (ex.: --latencia-es alta) são reduzidas a LARGURA_MAXIMA_GANTT colunas, cada uma com 'escala' ut.
+    escala = (totalUt - inicioGrafico + LARGURA_MAXIMA_GANTT - 1) / LARGURA_MAXIMA_GANTT;
+    colunas = (totalUt - inicioGrafico + escala - 1) / escala;
+
+    for(int i = 0; i < maquina->numeroDeProgramas; i++){
+        if(!(linhas[i] = malloc(colunas + 1))){
+            while(i-- > 0)
+                free(linhas[i]);
+            return;
+        }
+        memset(linhas[i], CHAR_VAZIO, colunas);
+        linhas[i][colunas] = CHAR_NULO;
+        estado[i] = (primeiro > 0) ? ESTADO_DESCONHECIDO : NOVA;
+        inicio[i] = inicioGrafico;
+    }
+
+    // Preenche cada coluna com o estado em que a tarefa se encontrava.
+    for(unsigned long long i = primeiro; i < registro->total; i++){
+        evento = &registro->eventos[i & (CAPACIDADE_REGISTRO_EVENTOS - 1)];
+
+        if(evento->tipo == EVENTO_ERRO){
+            marcarColunasGantt(linhas[evento->tarefa], evento->ut, evento->ut + 1, 'E', inicioGrafico, escala, totalUt);
+            continue;
+        }
+
+        marcarColunasGantt(linhas[evento->tarefa], inicio[evento->tarefa], evento->ut,
+                           (estado[evento->tarefa] == ESTADO_DESCONHECIDO) ? '?' : simbolosEstados[estado[evento->tarefa]], inicioGrafico, escala, totalUt);
+
+        if(evento->tipo == EVENTO_MIGRACAO && evento->estadoNovo == TERMINADA)
+            marcarColunasGantt(linhas[evento->tarefa], evento->ut, evento->ut + 1, 'M', inicioGrafico, escala, totalUt);
+
+        estado[evento->tarefa] = evento->estadoNovo;
+        inicio[evento->tarefa] = evento->ut;
+    }
+
+    // Uma tarefa sem nenhum evento guardado permanece desconhecida até o fim.
+    for(int i = 0; i < maquina->numeroDeProgramas; i++)
+        if(estado[i] == ESTADO_DESCONHECIDO)
+            memset(linhas[i], '?', colunas);
+
+    if(escala > 1)
+        printf("\n\n\t- Gantt (ut, cada coluna = %u ut)", escala);
+    else
+        printf("\n\n\t- Gantt (ut)");
+    if(inicioGrafico > 0)
+        printf("\n\tEventos anteriores a %u ut descartados (registro cheio)", inicioGrafico);
+    for(UnidadeTempo coluna = 0; coluna < colunas; coluna += COLUNAS_GANTT){
+        printf("\n\t%-12s %u", "", inicioGrafico + coluna * escala);
+        for(int i = 0; i < maquina->numeroDeProgramas; i++)
+            printf("\n\t%-12.12s|%.*s|", maquina->df[i].tarefa->nome, COLUNAS_GANTT, &linhas[i][coluna]);
+    }
+
+    for(int i = 0; i < maquina->numeroDeProgramas; i++)
+        free(linhas[i]);
+}
+
+void marcarColunasGantt(char *linha, UnidadeTempo de, UnidadeTempo ate, char simbolo, UnidadeTempo inicioGrafico, UnidadeTempo escala, UnidadeTempo totalUt){
+    // Em uma coluna com mais de uma ut prevalece o símbolo mais relevante (o último da lista).
+    const char *prioridade = " ?.s#ME";
+
+    if(ate > totalUt) ate = totalUt;
+    if(de < inicioGrafico) de = inicioGrafico;
+
+    for(UnidadeTempo coluna = (de - inicioGrafico) / escala; de < ate && coluna <= (ate - 1 - inicioGrafico) / escala; coluna++)
+        if(strchr(prioridade, simbolo) > strchr(prioridade, linha[coluna]))
+            linha[coluna] = simbolo;
+}
+
+int contarEstadoTarefas(DescritorTarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS], unsigned short quantidade, EstadoTarefa estado){
+    int cont = 0;
+    for(int index = 0; index < quantidade; index++)
+        if(tarefas[index].estado == estado)
+            cont++;
+
+    return cont;
+}
+
+QuadroMigracao * criarQuadroMigracao(int numeroDeProcessos){
+    QuadroMigracao *quadro;
+    pthread_mutexattr_t atributos;
+
+    quadro = mmap(NULL, sizeof(QuadroMigracao), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(quadro == MAP_FAILED)
+        return NULL;
+
+    memset(quadro, 0, sizeof(QuadroMigracao));
+    quadro->numeroDeProcessos = numeroDeProcessos;
+    for(int i = 0; i < NUMERO_MAXIMO_DE_PROCESSOS; i++)
+        quadro->pedido[i] = SEM_PEDIDO;
+
+    // A trava precisa ser compartilhada entre processos, e não apenas entre threads.
+    pthread_mutexattr_init(&atributos);
+    pthread_mutexattr_setpshared(&atributos, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&quadro->trava, &atributos);
+    pthread_mutexattr_destroy(&atributos);
+
+    return quadro;
+}
+
+void destruirQuadroMigracao(QuadroMigracao *quadro){
+    pthread_mutex_destroy(&quadro->trava);
+    munmap(quadro, sizeof(QuadroMigracao));
+}
+
+void coordenarMigracoes(QuadroMigracao *quadro, pid_t processos[], int numeroDeProcessos){
+    int vivos = 0, status, origem, emTransito;
+
+    // Os processos que não puderam ser criados não são aguardados.
+    for(int i = 0; i < numeroDeProcessos; i++)
+        if(processos[i] > 0) vivos++;
+
+    while(vivos > 0){
+        // Recolhe os processos filhos encerrados sem bloquear o coordenador.
+        for(int i = 0; i < numeroDeProcessos; i++)
+            if(processos[i] > 0 && waitpid(processos[i], &status, WNOHANG) == processos[i]){
+                processos[i] = 0;
+                vivos--;
+            }
+
+        pthread_mutex_lock(&quadro->trava);
+
+        // Verifica se ainda há alguma tarefa a caminho de um processo (pedida ou na caixa de entrada).
+        emTransito = FALSE;
+        for(int i = 0; i < numeroDeProcessos; i++)
+            if(quadro->pedido[i] != SEM_PEDIDO || quadro->caixa[i].ocupada)
+                emTransito = TRUE;
+
+        for(int destino = 0; destino < numeroDeProcessos; destino++){
+            if(!quadro->ocioso[destino] || quadro->encerrar[destino] || quadro->caixa[destino].ocupada)
+                continue;
+
+            // Escolhe o processo com mais tarefas PRONTAS e sem pedido pendente.
+            origem = NAO_ENCONTRADO;
+            for(int i = 0; i < numeroDeProcessos; i++)
+                if(i != destino && processos[i] > 0 && !quadro->ocioso[i] && quadro->pedido[i] == SEM_PEDIDO && quadro->prontas[i] > 0
+                   && (origem == NAO_ENCONTRADO || quadro->prontas[i] > quadro->prontas[origem]))
+                    origem = i;
+
+            if(origem != NAO_ENCONTRADO){
+                quadro->pedido[origem] = destino;
+                emTransito = TRUE;
+            } else if(!emTransito){
+                // Nenhum processo possui tarefas a migrar: a carga só diminui a partir daqui.
+                int haProntas = FALSE;
+                for(int i = 0; i < numeroDeProcessos; i++)
+                    if(processos[i] > 0 && quadro->prontas[i] > 0)
+                        haProntas = TRUE;
+                if(!haProntas)
+                    quadro->encerrar[destino] = TRUE;
+            }
+        }
+
+        pthread_mutex_unlock(&quadro->trava);
+
+        if(vivos > 0)
+            usleep(INTERVALO_COORDENACAO_US);
+    }
+}
+
+void atenderPedidoMigracao(QuadroMigracao *quadro, int processo, MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short indexFila){
+    long long inicio;
+    int destino, index;
+
+    pthread_mutex_lock(&quadro->trava);
+    quadro->prontas[processo] = contarEstadoTarefas(maquina->df, maquina->numeroDeProgramas, PRONTA);
+    destino = quadro->pedido[processo];
+
+    /* Sem pedido, o próprio processo entrega uma tarefa PRONTA a um processo ocioso: o balanceamento acompanha as voltas do escalonador
+       em vez do intervalo do coordenador, que é maior que a execução inteira de programas curtos. */
+    if(destino == SEM_PEDIDO && quadro->prontas[processo] > 0)
+        destino = procurarProcessoOcioso(quadro, processo);
+
+    if(destino != SEM_PEDIDO){
+        inicio = obterTempoNs();
+
+        // Procura uma tarefa PRONTA que não seja a tarefa em execução.
+        for(index = 0; index < maquina->numeroDeProgramas; index++)
+            if(maquina->df[index].estado == PRONTA && index != indexFila)
+                break;
+
+        if(index < maquina->numeroDeProgramas && !quadro->caixa[destino].ocupada){
+            quadro->caixa[destino].descritor = maquina->df[index];
+            memcpy(quadro->caixa[destino].variaveis, maquina->df[index].variaveis, maquina->df[index].quantidadeVariaveis * sizeof(int));
+            quadro->caixa[destino].medidas = roudRobin->medidas[index];
+            quadro->caixa[destino].contadores = roudRobin->contadores[index];
+            quadro->caixa[destino].ocupada = TRUE;
+
+            // A tarefa deixa de pertencer a este processo.
+            registrarEvento(&roudRobin->eventos, EVENTO_MIGRACAO, index, PRONTA, TERMINADA, roudRobin->contadorCPU, 0);
+            maquina->df[index].estado = TERMINADA;
+            maquina->df[index].migrada = TRUE;
+            free(maquina->df[index].variaveis);
+            maquina->df[index].variaveis = NULL;
+            quadro->prontas[processo]--;
+
+            roudRobin->migracoesEnviadas++;
+            roudRobin->custoMigracaoNs += obterTempoNs() - inicio;
+        }
+
+        quadro->pedido[processo] = SEM_PEDIDO;
+    }
+
+    pthread_mutex_unlock(&quadro->trava);
+}
+
+int procurarProcessoOcioso(QuadroMigracao *quadro, int processo){
+    for(int destino = 0; destino < quadro->numeroDeProcessos; destino++){
+        if(destino == processo || !quadro->ocioso[destino] || quadro->encerrar[destino] || quadro->caixa[destino].ocupada)
+            continue;
+
+        // Um destino que já tem uma tarefa pedida pelo coordenador a caminho não recebe outra.
+        int pedido = FALSE;
+        for(int origem = 0; origem < quadro->numeroDeProcessos; origem++)
+            if(quadro->pedido[origem] == destino)
+                pedido = TRUE;
+        if(!pedido)
+            return destino;
+    }
+
+    return SEM_PEDIDO;
+}
+
+int aguardarMigracao(QuadroMigracao *quadro, int processo, MaquinaExecucao *maquina, RoundRobin *roudRobin){
+    long long inicio = obterTempoNs(), inicioTransferencia;
+    int index, recebida = FALSE;
+
+    // Sem posição livre para outra tarefa, o processo deixa de receber migrações e encerra.
+    if(maquina->numeroDeProgramas >= NUMERO_MAXIMO_DE_PROGRAMAS){
+        pthread_mutex_lock(&quadro->trava);
+        quadro->prontas[processo] = 0;
+        quadro->encerrar[processo] = TRUE;
+        pthread_mutex_unlock(&quadro->trava);
+        return FALSE;
+    }
+
+    while(TRUE){
+        pthread_mutex_lock(&quadro->trava);
+        quadro->prontas[processo] = 0;
+        quadro->ocioso[processo] = TRUE;
+
+        if(quadro->caixa[processo].ocupada){
+            inicioTransferencia = obterTempoNs();
+
+            // Acrescenta a tarefa recebida ao final da fila deste processo.
+            index = maquina->numeroDeProgramas++;
+            maquina->df[index] = quadro->caixa[processo].descritor;
+            maquina->df[index].migrada = FALSE;
+            maquina->df[index].variaveis = malloc((maquina->df[index].quantidadeVariaveis + 1) * sizeof(int));
+            if(!maquina->df[index].variaveis){
+                printf(ERRO_MEMORIA_INSUFICIENTE);
+                encerrarProcessoFilho(EXIT_FAILURE);
+            }
+            memcpy(maquina->df[index].variaveis, quadro->caixa[processo].variaveis, maquina->df[index].quantidadeVariaveis * sizeof(int));
+            roudRobin->tempoEntradaESaidaFila[index][0] = roudRobin->admissao[index] = roudRobin->contadorCPU;
+            roudRobin->tempoAnterior[index][0] = maquina->df[index].tempoCPU;
+            roudRobin->tempoAnterior[index][1] = maquina->df[index].tempoES;
+            roudRobin->medidas[index] = quadro->caixa[processo].medidas;
+            roudRobin->contadores[index] = quadro->caixa[processo].contadores;
+            registrarEvento(&roudRobin->eventos, EVENTO_MIGRACAO, index, NOVA, PRONTA, roudRobin->contadorCPU, 0);
+            quadro->caixa[processo].ocupada = FALSE;
+            quadro->ocioso[processo] = FALSE;
+
+            roudRobin->migracoesRecebidas++;
+            roudRobin->custoMigracaoNs += obterTempoNs() - inicioTransferencia;
+            recebida = TRUE;
+        }
+
+        if(recebida || quadro->encerrar[processo]){
+            pthread_mutex_unlock(&quadro->trava);
+            break;
+        }
+
+        pthread_mutex_unlock(&quadro->trava);
+        usleep(INTERVALO_COORDENACAO_US);
+    }
+
+    roudRobin->esperaMigracaoNs += obterTempoNs() - inicio;
+    return recebida;
+}
+
+long long obterTempoNs(){
+    struct timespec tempo;
+    clock_gettime(CLOCK_MONOTONIC, &tempo);
+    return (long long) tempo.tv_sec * 1000000000LL + tempo.tv_nsec;
+}
+
+int decodificarPrograma(Programa *programa, ProgramaDecodificado *decodificado, ErroExecucao *erro){
+    Instrucao copia;
+    InstrucaoDecodificada *instrucao;
+    char *argumento;
+    int tipoInstrucao, valor, simbolo, erroDecodificacao;
+
+    decodificado->quantidadeVariaveis = decodificado->quantidadeSimbolos = 0;
+    decodificado->quantidadeLeituras = decodificado->quantidadeEscritas = 0;
+    decodificado->quantidadeInstrucoesVetor = 0;
+
+    for(unsigned short pc = 0; pc < programa->numeroDeInstrucoes; pc++){
+        instrucao = &decodificado->instrucoes[pc];
+        strcpy(copia, programa->instrucoes[pc]);
+        tipoInstrucao = identificarInstrucao(copia);
+        argumento = (tipoInstrucao != NAO_ENCONTRADO) ? obterArgumento() : NULL;
+
+        instrucao->codigo = tipoInstrucao;
+        instrucao->tipoArgumento = ARGUMENTO_NENHUM;
+        instrucao->valor = 0;
+        erroDecodificacao = EXECUCAO_BEM_SUCEDIDA;
+
+        if(tipoInstrucao == NAO_ENCONTRADO)
+            erroDecodificacao = INSTRUCAO_LPAS_INVALIDA;
+        else if(tipoInstrucao >= ARRAY)
+            erroDecodificacao = decodificarInstrucaoVetor(tipoInstrucao, argumento, pc, decodificado);
+        else if(argumento && obterArgumento())
+            erroDecodificacao = MUITAS_INSTRUCOES;
+        else if(tipoInstrucao == HALT){
+            // As instruções após o HALT nunca são executadas.
+            decodificado->numeroDeInstrucoes = pc + 1;
+            decodificado->hash = calcularHashPrograma(decodificado);
+            decodificado->nativo = NULL;
+            return EXECUCAO_BEM_SUCEDIDA;
+        } else if(!argumento)
+            erroDecodificacao = ARGUMENTO_INSTRUCAO_LPAS_AUSENTE;
+        else if(converterNumero(argumento, &valor)){
+            // READ e STORE precisam de uma variável como destino.
+            if(tipoInstrucao == READ || tipoInstrucao == STORE)
+                erroDecodificacao = ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
+            else {
+                instrucao->tipoArgumento = ARGUMENTO_IMEDIATO;
+                instrucao->valor = valor;
+            }
+        } else {
+            // Somente READ e STORE criam variáveis; as demais instruções exigem uma variável já definida. Um vetor não é operando das instruções simples.
+            simbolo = procurarVariavel(decodificado, argumento);
+            if(simbolo == NAO_ENCONTRADO && (tipoInstrucao == READ || tipoInstrucao == STORE))
+                simbolo = criarVariavel(decodificado, argumento, 0);
+
+            if(simbolo == NAO_ENCONTRADO || decodificado->simbolos[simbolo].tamanho)
+                erroDecodificacao = ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
+            else {
+                instrucao->tipoArgumento = ARGUMENTO_VARIAVEL;
+                instrucao->valor = decodificado->simbolos[simbolo].endereco;
+            }
+        }
+
+        if(erroDecodificacao != EXECUCAO_BEM_SUCEDIDA){
+            *erro = geradorDeErrosLpas(programa->linhas[pc], programa->instrucoes[pc], programa->nome, erroDecodificacao);
+            return erroDecodificacao;
+        }
+
+        if(tipoInstrucao == READ) decodificado->quantidadeLeituras++;
+        if(tipoInstrucao == WRITE) decodificado->quantidadeEscritas++;
+    }
+
+    // O programa terminou sem a instrução HALT.
+    *erro = geradorDeErrosLpas(programa->numeroDeInstrucoes ? programa->linhas[programa->numeroDeInstrucoes - 1] : 0, programa->numeroDeInstrucoes ? programa->instrucoes[programa->numeroDeInstrucoes - 1] : "", programa->nome, INSTRUCAO_LPAS_INVALIDA);
+    return INSTRUCAO_LPAS_INVALIDA;
+}
+
+int decodificarInstrucaoVetor(int tipoInstrucao, char *argumento, unsigned short pc, ProgramaDecodificado *decodificado){
+    OperandosVetor *vetor = &decodificado->operandosVetor[pc];
+    int simbolo, valor, doisArgumentos = tipoInstrucao == ARRAY || (tipoInstrucao >= VADD && tipoInstrucao <= VDIV);
+    char *segundo = argumento ? obterArgumento() : NULL;
+
+    if(!argumento || (doisArgumentos && !segundo))
+        return ARGUMENTO_INSTRUCAO_LPAS_AUSENTE;
+    if((!doisArgumentos && segundo) || (segundo && obterArgumento()))
+        return MUITAS_INSTRUCOES;
+
+    if(tipoInstrucao == ARRAY){
+        // ARRAY cria o vetor, que não pode ter o nome de uma variável existente.
+        if(converterNumero(argumento, &valor) || procurarVariavel(decodificado, argumento) != NAO_ENCONTRADO
+            || !converterNumero(segundo, &valor) || valor < 1 || valor > TAMANHO_MAXIMO_VETOR
+            || (simbolo = criarVariavel(decodificado, argumento, valor)) == NAO_ENCONTRADO)
+            return ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
+    } else if((simbolo = procurarVariavel(decodificado, argumento)) == NAO_ENCONTRADO || !decodificado->simbolos[simbolo].tamanho)
+        return ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
+
+    vetor->endereco = decodificado->simbolos[simbolo].endereco;
+    vetor->tamanho = decodificado->simbolos[simbolo].tamanho;
+    vetor->tipoOrigem = ARGUMENTO_NENHUM;
+    vetor->origem = 0;
+
+    // O segundo operando das operações elemento a elemento é um número, uma variável simples ou um vetor do mesmo tamanho.
+    if(tipoInstrucao >= VADD && tipoInstrucao <= VDIV){
+        if(converterNumero(segundo, &valor)){
+            vetor->tipoOrigem = ARGUMENTO_IMEDIATO;
+            vetor->origem = valor;
+        } else {
+            if((simbolo = procurarVariavel(decodificado, segundo)) == NAO_ENCONTRADO
+                || (decodificado->simbolos[simbolo].tamanho && decodificado->simbolos[simbolo].tamanho != vetor->tamanho))
+                return ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
+            vetor->tipoOrigem = decodificado->simbolos[simbolo].tamanho ? ARGUMENTO_VETOR : ARGUMENTO_VARIAVEL;
+            vetor->origem = decodificado->simbolos[simbolo].endereco;
+        }
+    }
+
+    decodificado->instrucoes[pc].tipoArgumento = ARGUMENTO_VETOR;
+    decodificado->instrucoes[pc].valor = pc;
+    decodificado->quantidadeInstrucoesVetor++;
+    if(tipoInstrucao == VREAD) decodificado->quantidadeLeituras += vetor->tamanho;
+    if(tipoInstrucao == VWRITE) decodificado->quantidadeEscritas += vetor->tamanho;
+
+    return EXECUCAO_BEM_SUCEDIDA;
+}
+
+int procurarVariavel(ProgramaDecodificado *decodificado, const char *nome){
+    for(int simbolo = 0; simbolo < decodificado->quantidadeSimbolos; simbolo++)
+        if(!strcmp(nome, decodificado->simbolos[simbolo].nome))
+            return simbolo;
+
+    return NAO_ENCONTRADO;
+}
+
+int criarVariavel(ProgramaDecodificado *decodificado, const char *nome, int tamanho){
+    SimboloVariavel *simbolo = &decodificado->simbolos[decodificado->quantidadeSimbolos];
+    int posicoes = tamanho ? tamanho : 1;
+
+    if(decodificado->quantidadeSimbolos == NUMERO_MAXIMO_DE_VARIAVEIS || decodificado->quantidadeVariaveis + posicoes > TAMANHO_MAXIMO_MEMORIA)
+        return NAO_ENCONTRADO;
+
+    // Os elementos do vetor ocupam posições consecutivas da memória de dados.
+    strcpy(simbolo->nome, nome);
+    simbolo->endereco = decodificado->quantidadeVariaveis;
+    simbolo->tamanho = tamanho;
+    decodificado->quantidadeVariaveis += posicoes;
+
+    return decodificado->quantidadeSimbolos++;
+}
+
+unsigned short calcularCustoVetor(int tamanho){
+    return (tamanho + LARGURA_VETOR_UT - 1) / LARGURA_VETOR_UT;
+}
+
+unsigned long long calcularHashPrograma(ProgramaDecodificado *decodificado){
+    unsigned long long hash = 14695981039346656037ULL; // FNV-1a de 64 bits.
+    OperandosVetor *vetor;
+    int campos[7], quantidade;
+
+    // Somente os campos das instruções entram no hash (o preenchimento da struct não é inicializado).
+    hash = (hash ^ VERSAO_CODIGO_NATIVO) * 1099511628211ULL;
+    for(unsigned short pc = 0; pc < decodificado->numeroDeInstrucoes; pc++){
+        campos[0] = decodificado->instrucoes[pc].codigo;
+        campos[1] = decodificado->instrucoes[pc].tipoArgumento;
+        campos[2] = decodificado->instrucoes[pc].valor;
+        quantidade = 3;
+
+        // As instruções de vetor também são identificadas pelos seus operandos.
+        if(decodificado->instrucoes[pc].tipoArgumento == ARGUMENTO_VETOR){
+            vetor = &decodificado->operandosVetor[pc];
+            campos[3] = vetor->endereco;
+            campos[4] = vetor->tamanho;
+            campos[5] = vetor->tipoOrigem;
+            campos[6] = vetor->origem;
+            quantidade = 7;
+        }
+
+        for(size_t i = 0; i < quantidade * sizeof(int); i++)
+            hash = (hash ^ ((unsigned char *) campos)[i]) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+int prepararDiretorioNativo(const char *diretorio){
+    struct stat informacoes;
+
+    if(mkdir(diretorio, 0700) < 0 && errno != EEXIST)
+        return FALSE;
+
+    return stat(diretorio, &informacoes) == 0 && S_ISDIR(informacoes.st_mode) && verificarDonoArquivo(diretorio);
+}
+
+int verificarDonoArquivo(const char *caminho){
+    struct stat informacoes;
+
+    return stat(caminho, &informacoes) == 0 && informacoes.st_uid == geteuid() && !(informacoes.st_mode & (S_IWGRP | S_IWOTH));
+}
+
+int compilarProgramaNativo(ProgramaDecodificado *decodificado, const char *nome){
+    char objeto[TAMANHO_CAMINHO_NATIVO], temporario[TAMANHO_CAMINHO_NATIVO], fonte[TAMANHO_CAMINHO_NATIVO];
+    const char *diretorio = configuracao.diretorioNativo;
+    void *biblioteca;
+    FILE *arquivo;
+    int compilado;
+
+    snprintf(objeto, sizeof(objeto), "%s/%016llx.so", diretorio, decodificado->hash);
+
+    if(access(objeto, R_OK) != 0){
+        // Threads e processos diferentes podem compilar o mesmo programa: cada um usa arquivos temporários próprios e o objeto é publicado com rename.
+        snprintf(fonte, sizeof(fonte), "%s/%016llx.%d.%lx.c", diretorio, decodificado->hash, (int) getpid(), (unsigned long) pthread_self());
+        snprintf(temporario, sizeof(temporario), "%s/%016llx.%d.%lx.so", diretorio, decodificado->hash, (int) getpid(), (unsigned long) pthread_self());
+
+        if(!(arquivo = fopen(fonte, "w")))
+            return FALSE;
+        gerarCodigoNativo(decodificado, nome, arquivo);
+        compilado = (fclose(arquivo) == 0) && executarCompilador(fonte, temporario) && rename(temporario, objeto) == 0;
+        unlink(fonte);
+
+        if(!compilado){
+            unlink(temporario);
+            return FALSE;
+        }
+    }
+
+    // A biblioteca permanece carregada até o fim do processo e é herdada pelos processos tes.
+    if(!verificarDonoArquivo(objeto) || !(biblioteca = dlopen(objeto, RTLD_NOW | RTLD_LOCAL)))
+        return FALSE;
+
+    *(void **) &decodificado->nativo = dlsym(biblioteca, SIMBOLO_NATIVO);
+    return decodificado->nativo ? TRUE : FALSE;
+}
+
+void gerarCodigoNativo(ProgramaDecodificado *decodificado, const char *nome, FILE *arquivo){
+    const char *operacoes[] = {[LOAD] = "a =", [ADD] = "a +=", [SUB] = "a -=", [MUL] = "a *=", [DIV] = "a /="};
+    InstrucaoDecodificada *instrucao;
+    char operando[32];
+
+    // O nome vem de um caminho: '*' é trocado para que um "*/" no nome não encerre o comentário do código gerado.
+    fprintf(arquivo, "/* ");
+    for(const char *c = nome; *c; c++)
+        fputc((*c == '*') ? '_' : *c, arquivo);
+    fprintf(arquivo, "%s (hash %016llx), gerado pelo tes. */\n", EXTENSAO_LPAS, decodificado->hash);
+    fprintf(arquivo, "#define PARAR(i) do { *registrador = a; *pc = (i); return n; } while(0)\n\n");
+    fprintf(arquivo, "unsigned %s(int *registrador, int *v, unsigned char *pc, unsigned limite){\n", SIMBOLO_NATIVO);
+    fprintf(arquivo, "    int a = *registrador;\n    unsigned n = 0;\n\n    switch(*pc){\n");
+
+    for(unsigned short pc = 0; pc < decodificado->numeroDeInstrucoes; pc++){
+        instrucao = &decodificado->instrucoes[pc];
+
+        if(instrucao->tipoArgumento == ARGUMENTO_VARIAVEL)
+            snprintf(operando, sizeof(operando), "v[%d]", instrucao->valor);
+        else
+            snprintf(operando, sizeof(operando), "(%d)", instrucao->valor);
+
+        // Cada instrução é um ponto de parada: o bloco termina ao atingir o limite ou antes de uma instrução do interpretador.
+        fprintf(arquivo, "    case %u: ", pc);
+        if(instrucao->codigo == READ || instrucao->codigo == WRITE || instrucao->codigo == HALT || instrucao->tipoArgumento == ARGUMENTO_VETOR
+            || (instrucao->codigo == DIV && instrucao->tipoArgumento == ARGUMENTO_IMEDIATO && instrucao->valor == 0))
+            fprintf(arquivo, "PARAR(%u);\n", pc);
+        else if(instrucao->codigo == DIV && instrucao->tipoArgumento == ARGUMENTO_VARIAVEL)
+            fprintf(arquivo, "if(n == limite || %s == 0) PARAR(%u); a /= %s; n++;\n", operando, pc, operando);
+        else if(instrucao->codigo == STORE)
+            fprintf(arquivo, "if(n == limite) PARAR(%u); %s = a; n++;\n", pc, operando);
+        else
+            fprintf(arquivo, "if(n == limite) PARAR(%u); %s %s; n++;\n", pc, operacoes[instrucao->codigo], operando);
+    }
+
+    fprintf(arquivo, "    }\n\n    PARAR(*pc);\n}\n");
+}
+
+int executarCompilador(const char *fonte, const char *objeto){
+    const char *compilador = getenv("CC") ? getenv("CC") : COMPILADOR_PADRAO;
+    char *argumentos[] = {(char *) compilador, "-O2", "-fPIC", "-shared", "-fwrapv", "-w", "-o", (char *) objeto, (char *) fonte, NULL};
+    posix_spawn_file_actions_t acoes;
+    pid_t pid;
+    int status, iniciado;
+
+    // posix_spawnp é seguro nas threads de carga, ao contrário de fork seguido de exec.
+    posix_spawn_file_actions_init(&acoes);
+    posix_spawn_file_actions_addopen(&acoes, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&acoes, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    iniciado = posix_spawnp(&pid, compilador, &acoes, NULL, argumentos, environ) == 0;
+    posix_spawn_file_actions_destroy(&acoes);
+
+    return iniciado && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+CacheResultados * criarCacheResultados(int capacidade){
+    CacheResultados *cache;
+    pthread_mutexattr_t atributos;
+
+    // A memória anônima é zerada: todas as posições começam vazias.
+    cache = mmap(NULL, sizeof(CacheResultados) + capacidade * sizeof(ResultadoMemoizado), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(cache == MAP_FAILED)
+        return NULL;
+
+    cache->capacidade = capacidade;
+
+    pthread_mutexattr_init(&atributos);
+    pthread_mutexattr_setpshared(&atributos, PTHREAD_PROCESS_SHARED);
+    for(int segmento = 0; segmento < SEGMENTOS_CACHE_RESULTADOS; segmento++)
+        pthread_mutex_init(&cache->segmentos[segmento].trava, &atributos);
+    pthread_mutexattr_destroy(&atributos);
+
+    return cache;
+}
+
+int obterEntradasMemoizacao(Tarefa *tarefa, const int **entradas){
+    int quantidade = tarefa->imagem->codigo.quantidadeLeituras;
+
+    // A reprodução não executa as instruções de vetor: os programas com vetores não são memoizados.
+    if(quantidade > MAXIMO_ENTRADAS_MEMO || tarefa->imagem->codigo.quantidadeEscritas > MAXIMO_ESCRITAS_MEMO || tarefa->imagem->codigo.quantidadeInstrucoesVetor)
+        return NAO_ENCONTRADO;
+
+    /* Com E/S bloqueante (--latencia-es) cada READ suspende a tarefa, e a reprodução, que não executa os READs, não reproduziria
+       as suspensões: o resultado de um programa com READ não é guardado nem reproduzido. */
+    if(quantidade > 0 && configuracao.latenciaES)
+        return NAO_ENCONTRADO;
+
+    // Sem valores suficientes o READ falha, e a execução não é completa.
+    if(tarefa->entradas){
+        *entradas = tarefa->entradas;
+        return (tarefa->quantidadeEntradas >= quantidade) ? quantidade : NAO_ENCONTRADO;
+    }
+
+    *entradas = NULL;
+    return (quantidade == 0) ? 0 : NAO_ENCONTRADO;
+}
+
+int posicaoCacheResultados(unsigned long long hashPrograma, const int *entradas, int quantidadeEntradas){
+    unsigned long long hash = hashPrograma;
+
+    for(int i = 0; i < quantidadeEntradas; i++)
+        hash = (hash ^ (unsigned) entradas[i]) * 1099511628211ULL;
+
+    // Finalizador do MurmurHash3: sem ele, entradas próximas (como as linhas de um CSV) caem em poucas posições e se substituem.
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return hash % cacheResultados->capacidade;
+}
+
+int consultarCacheResultados(ProgramaDecodificado *codigo, const int *entradas, int quantidadeEntradas, ResultadoMemoizado *resultado){
+    int indice = posicaoCacheResultados(codigo->hash, entradas, quantidadeEntradas);
+    ResultadoMemoizado *posicao = &cacheResultados->resultados[indice];
+    SegmentoCacheResultados *segmento = &cacheResultados->segmentos[indice % SEGMENTOS_CACHE_RESULTADOS];
+    int acerto;
+
+    pthread_mutex_lock(&segmento->trava);
+    acerto = posicao->hashPrograma == codigo->hash && posicao->quantidadeEntradas == quantidadeEntradas
+             && !memcmp(posicao->entradas, entradas, quantidadeEntradas * sizeof(int));
+    if(acerto){
+        *resultado = *posicao;
+        segmento->acertos++;
+    }
+    segmento->consultas++;
+    pthread_mutex_unlock(&segmento->trava);
+
+    return acerto;
+}
+
+void guardarCacheResultados(ProgramaDecodificado *codigo, const int *entradas, int quantidadeEntradas, ResultadoMemoizado *resultado){
+    int indice = posicaoCacheResultados(codigo->hash, entradas, quantidadeEntradas);
+    ResultadoMemoizado *posicao = &cacheResultados->resultados[indice];
+    SegmentoCacheResultados *segmento = &cacheResultados->segmentos[indice % SEGMENTOS_CACHE_RESULTADOS];
+
+    if(resultado->quantidadeEscritas != codigo->quantidadeEscritas || resultado->quantidadeEscritas > MAXIMO_ESCRITAS_MEMO)
+        return;
+
+    resultado->hashPrograma = codigo->hash;
+    resultado->quantidadeEntradas = quantidadeEntradas;
+    memcpy(resultado->entradas, entradas, quantidadeEntradas * sizeof(int));
+
+    // Outra tarefa com o mesmo programa e as mesmas entradas pode ter guardado o resultado primeiro.
+    pthread_mutex_lock(&segmento->trava);
+    if(posicao->hashPrograma != resultado->hashPrograma || posicao->quantidadeEntradas != quantidadeEntradas
+        || memcmp(posicao->entradas, entradas, quantidadeEntradas * sizeof(int))){
+        if(posicao->hashPrograma)
+            segmento->substituicoes++;
+        *posicao = *resultado;
+        segmento->insercoes++;
+    }
+    pthread_mutex_unlock(&segmento->trava);
+}
+
+void consultarMemoizacaoTarefas(Tarefa tarefas[], unsigned short quantidadeProgramas){
+    ResultadoMemoizado resultado;
+    const int *entradas;
+    int quantidade;
+
+    for(int i = 0; i < quantidadeProgramas; i++){
+        tarefas[i].memoizada = FALSE;
+        tarefas[i].resultado.quantidadeEscritas = 0;
+
+        quantidade = obterEntradasMemoizacao(&tarefas[i], &entradas);
+        if(quantidade != NAO_ENCONTRADO && consultarCacheResultados(&tarefas[i].imagem->codigo, entradas, quantidade, &resultado)){
+            tarefas[i].resultado = resultado;
+            tarefas[i].memoizada = TRUE;
+        }
+    }
+}
+
+void memoizarTarefa(DescritorTarefa *descritor){
+    Tarefa *tarefa = descritor->tarefa;
+    const int *entradas;
+    int quantidade = obterEntradasMemoizacao(tarefa, &entradas);
+
+    // Uma tarefa migrada registrou parte das escritas no processo de origem e não é guardada (a contagem de escritas não confere).
+    if(quantidade == NAO_ENCONTRADO || descritor->abortada)
+        return;
+
+    tarefa->resultado.tempoCPU = descritor->tempoCPU;
+    tarefa->resultado.tempoES = descritor->tempoES;
+    guardarCacheResultados(&tarefa->imagem->codigo, entradas, quantidade, &tarefa->resultado);
+}
+
+void servirTarefaMemoizada(DescritorTarefa *descritor){
+    ResultadoMemoizado *resultado = &descritor->tarefa->resultado;
+
+    for(int escrita = 0; escrita < resultado->quantidadeEscritas; escrita++)
+        printf("%s -> %s: %d\n", descritor->tarefa->nome, INST_WRITE, resultado->escritas[escrita]);
+
+    // Sem desvios, a execução guardada chegou ao primeiro HALT. O tempo guardado inclui a ut do HALT, que é executado pelo interpretador
+    // e termina a tarefa como no término normal.
+    while(descritor->instrucoes[descritor->pc].codigo != HALT)
+        descritor->pc++;
+    descritor->ciclosPendentes = resultado->tempoCPU - 1;
+    descritor->tempoES = resultado->tempoES;
+}
+
+void exibirMemoizacao(){
+    unsigned long long consultas = 0, acertos = 0, insercoes = 0, substituicoes = 0;
+    SegmentoCacheResultados *segmento;
+
+    for(int index = 0; index < SEGMENTOS_CACHE_RESULTADOS; index++){
+        segmento = &cacheResultados->segmentos[index];
+        pthread_mutex_lock(&segmento->trava);
+        consultas += segmento->consultas;
+        acertos += segmento->acertos;
+        insercoes += segmento->insercoes;
+        substituicoes += segmento->substituicoes;
+        pthread_mutex_unlock(&segmento->trava);
+    }
+
+    printf("- Memoização (cache de %d resultados)", cacheResultados->capacidade);
+    printf("\n\tConsultas = %llu", consultas);
+    printf("\n\tAcertos = %llu (%.2f%%)", acertos, consultas ? acertos * 100.0 / consultas : 0);
+    printf("\n\tResultados guardados = %llu (%llu substituições)", insercoes, substituicoes);
+}
+
+int converterNumero(const char *str, int *valor){
+    char *fim;
+    long numero;
+
+    if(stringVazia(str))
+        return FALSE;
+
+    numero = strtol(str, &fim, 10);
+    if(*fim != CHAR_NULO)
+        return FALSE;
+
+    *valor = (int) numero;
+    return TRUE;
+}
+
+int lerLinhaEntradas(FILE *arquivo, int valores[], int maximo){
+    char linha[TAMANHO_LINHA_ENTRADAS], *tok, *contexto;
+    int colunas, c, cortada;
+    size_t tamanho;
+
+    do {
+        if(!fgets(linha, TAMANHO_LINHA_ENTRADAS, arquivo))
+            return NAO_ENCONTRADO;
+
+        /* Uma linha maior que o buffer é lida por inteiro, para que as linhas seguintes mantenham a sua numeração: o restante é
+           descartado, assim como o último valor do buffer caso tenha sido cortado (um READ sem valor falha na linha). */
+        tamanho = strlen(linha);
+        cortada = tamanho == TAMANHO_LINHA_ENTRADAS - 1 && linha[tamanho - 1] != EOL;
+        if(cortada){
+            if((c = getc(arquivo)) != EOF && !strchr(SEPARADORES_ENTRADAS, c))
+                while(tamanho > 0 && !strchr(SEPARADORES_ENTRADAS, linha[tamanho - 1]))
+                    linha[--tamanho] = CHAR_NULO;
+            while(c != EOF && c != EOL)
+                c = getc(arquivo);
+        }
+
+        tok = strtok_r(linha, SEPARADORES_ENTRADAS, &contexto);
+    } while(!tok && !cortada); // Ignora as linhas vazias (uma linha cortada não é vazia, mesmo sem nenhum valor completo).
+
+    // Uma coluna não numérica encerra a linha: o READ correspondente falhará com SIMBOLO_INVALIDO.
+    for(colunas = 0; tok && colunas < maximo; tok = strtok_r(NULL, SEPARADORES_ENTRADAS, &contexto), colunas++)
+        if(!converterNumero(tok, &valores[colunas]))
+            break;
+
+    return colunas;
+}
+
+int executarModoSimd(const char *nomePrograma, const char *arquivoEntradas){
+    Tarefa tarefa;
+    ProgramaDecodificado *programa;
+    LoteInstancias lote;
+    KernelAritmetico kernel;
+    const char *nomeKernel;
+    FILE *arquivo;
+    int valores[NUMERO_MAXIMO_DE_INSTRUCOES], colunas, instancia;
+    unsigned long totalInstancias = 0;
+    long long inicio, tempoExecucao = 0;
+
+    snprintf(tarefa.nome, TAMANHO_NOME_ARQUIVO, "%s", nomePrograma);
+    if(!carregarTarefas(&tarefa, 1))
+        return EXIT_FAILURE;
+    programa = &tarefa.imagem->codigo;
+
+    // As instâncias são as lanes dos kernels: os vetores de cada instância não cabem na memória organizada por linhas.
+    if(programa->quantidadeInstrucoesVetor){
+        printf(ERRO_SIMD_VETORES, nomePrograma);
+        liberarImagemPrograma(tarefa.imagem);
+        return EXIT_FAILURE;
+    }
+
+    if(!(arquivo = fopen(arquivoEntradas, APENAS_LEITURA))){
+        printf(ERRO_ARQUIVO_NAO_EXISTE, arquivoEntradas);
+        liberarImagemPrograma(tarefa.imagem);
+        return EXIT_FAILURE;
+    }
+
+    if(!alocarLoteInstancias(&lote, programa)){
+        printf(ERRO_MEMORIA_INSUFICIENTE);
+        fclose(arquivo);
+        liberarImagemPrograma(tarefa.imagem);
+        return EXIT_FAILURE;
+    }
+
+    kernel = selecionarKernelAritmetico(&nomeKernel);
+
+    while(TRUE){
+        // Preenche o bloco: cada linha do arquivo é uma instância e cada coluna alimenta um READ.
+        for(lote.quantidadeInstancias = 0; lote.quantidadeInstancias < INSTANCIAS_POR_BLOCO; lote.quantidadeInstancias++){
+            colunas = lerLinhaEntradas(arquivo, valores, NUMERO_MAXIMO_DE_INSTRUCOES);
+            if(colunas == NAO_ENCONTRADO) break;
+
+            instancia = lote.quantidadeInstancias;
+            lote.colunas[instancia] = colunas;
+            for(int leitura = 0; leitura < lote.colunas[instancia] && leitura < programa->quantidadeLeituras; leitura++)
+                lote.entradas[leitura * INSTANCIAS_POR_BLOCO + instancia] = valores[leitura];
+        }
+
+        if(lote.quantidadeInstancias == 0) break;
+
+        inicio = obterTempoNs();
+        executarLoteInstancias(programa, &lote, kernel);
+        tempoExecucao += obterTempoNs() - inicio;
+
+        exibirSaidasLote(programa, &lote, &tarefa.imagem->programa, totalInstancias + 1);
+        totalInstancias += lote.quantidadeInstancias;
+    }
+
+    printf("\n- Modo vetorial (kernel %s)", nomeKernel);
+    printf("\n\tInstâncias executadas = %lu", totalInstancias);
+    printf("\n\tTempo de execução = %.3f ms", tempoExecucao / 1000000.0);
+    printf("\n\tInstâncias por segundo = %.0f\n\n", tempoExecucao ? totalInstancias * 1000000000.0 / tempoExecucao : 0);
+
+    liberarLoteInstancias(&lote);
+    fclose(arquivo);
+    liberarImagemPrograma(tarefa.imagem);
+
+    return EXIT_SUCCESS;
+}
+
+int alocarLoteInstancias(LoteInstancias *lote, ProgramaDecodificado *programa){
+    size_t linha = INSTANCIAS_POR_BLOCO * sizeof(int);
+
+    // As linhas são alinhadas em 32 bytes (largura de um registrador AVX2); +1 evita alocações de tamanho 0.
+    lote->registradores = aligned_alloc(32, linha);
+    lote->variaveis = aligned_alloc(32, linha * (programa->quantidadeVariaveis + 1));
+    lote->entradas = aligned_alloc(32, linha * (programa->quantidadeLeituras + 1));
+    lote->saidas = aligned_alloc(32, linha * (programa->quantidadeEscritas + 1));
+    lote->colunas = malloc(INSTANCIAS_POR_BLOCO * sizeof(unsigned short));
+    lote->erros = malloc(INSTANCIAS_POR_BLOCO * sizeof(unsigned char));
+    lote->pcErro = malloc(INSTANCIAS_POR_BLOCO * sizeof(unsigned short));
+
+    if(!lote->registradores || !lote->variaveis || !lote->entradas || !lote->saidas || !lote->colunas || !lote->erros || !lote->pcErro){
+        liberarLoteInstancias(lote);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void liberarLoteInstancias(LoteInstancias *lote){
+    free(lote->registradores);
+    free(lote->variaveis);
+    free(lote->entradas);
+    free(lote->saidas);
+    free(lote->colunas);
+    free(lote->erros);
+    free(lote->pcErro);
+}
+
+void executarLoteInstancias(ProgramaDecodificado *programa, LoteInstancias *lote, KernelAritmetico kernel){
+    InstrucaoDecodificada *instrucao;
+    int quantidade = lote->quantidadeInstancias, *operandos, *destino;
+    unsigned short leitura = 0, escrita = 0;
+
+    memset(lote->erros, EXECUCAO_BEM_SUCEDIDA, quantidade);
+    memset(lote->registradores, 0, quantidade * sizeof(int));
+
+    // O programa LPAS não possui desvios: todas as instâncias executam a mesma sequência de instruções.
+    for(unsigned short pc = 0; pc < programa->numeroDeInstrucoes; pc++){
+        instrucao = &programa->instrucoes[pc];
+        operandos = (instrucao->tipoArgumento == ARGUMENTO_VARIAVEL) ? &lote->variaveis[instrucao->valor * INSTANCIAS_POR_BLOCO] : NULL;
+
+        switch(instrucao->codigo){
+        case READ:
+            // Mascara as instâncias cuja linha não possui valores suficientes (equivale a um READ inválido).
+            for(int i = 0; i < quantidade; i++)
+                if(lote->colunas[i] <= leitura && lote->erros[i] == EXECUCAO_BEM_SUCEDIDA){
+                    lote->erros[i] = SIMBOLO_INVALIDO;
+                    lote->pcErro[i] = pc + 1;
+                }
+            memcpy(operandos, &lote->entradas[leitura++ * INSTANCIAS_POR_BLOCO], quantidade * sizeof(int));
+            break;
+        case WRITE:
+            destino = &lote->saidas[escrita++ * INSTANCIAS_POR_BLOCO];
+            if(operandos)
+                memcpy(destino, operandos, quantidade * sizeof(int));
+            else
+                for(int i = 0; i < quantidade; i++) destino[i] = instrucao->valor;
+            break;
+        case LOAD:
+            if(operandos)
+                memcpy(lote->registradores, operandos, quantidade * sizeof(int));
+            else
+                for(int i = 0; i < quantidade; i++) lote->registradores[i] = instrucao->valor;
+            break;
+        case STORE:
+            memcpy(operandos, lote->registradores, quantidade * sizeof(int));
+            break;
+        case ADD:
+        case SUB:
+        case MUL:
+            kernel(instrucao->codigo, lote->registradores, operandos, instrucao->valor, quantidade);
+            break;
+        case DIV:
+            dividirInstancias(lote->registradores, operandos, instrucao->valor, quantidade, lote->erros, lote->pcErro, pc + 1);
+            break;
+        case HALT:
+            return;
+        }
+    }
+}
+
+void dividirInstancias(int *registradores, const int *operandos, int escalar, int quantidade, unsigned char *erros, unsigned short *pcErro, unsigned short pc){
+    int divisor;
+
+    // Não há divisão inteira SIMD no x86: a divisão é escalar, com as instâncias de divisor 0 mascaradas.
+    for(int i = 0; i < quantidade; i++){
+        divisor = operandos ? operandos[i] : escalar;
+        if(divisor == 0){
+            if(erros[i] == EXECUCAO_BEM_SUCEDIDA){
+                erros[i] = ARGUMENTO_INSTRUCAO_LPAS_INVALIDO;
+                pcErro[i] = pc;
+            }
+        } else if(divisor == -1) // Evita a exceção de INT_MIN / -1.
+            registradores[i] = (int) (0u - (unsigned) registradores[i]);
+        else
+            registradores[i] /= divisor;
+    }
+}
+
+KernelAritmetico selecionarKernelAritmetico(const char **nome){
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){
+        *nome = "AVX2";
+        return kernelAritmeticoAvx2;
+    }
+    if(__builtin_cpu_supports("sse4.1")){
+        *nome = "SSE4.1";
+        return kernelAritmeticoSse41;
+    }
+#endif
+    *nome = "escalar";
+    return kernelAritmeticoEscalar;
+}
+
+KernelReducao selecionarKernelReducao(){
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+        return kernelReducaoAvx2;
+    if(__builtin_cpu_supports("sse4.1"))
+        return kernelReducaoSse41;
+#endif
+    return kernelReducaoEscalar;
+}
+
+int combinarReducao(int codigo, int resultado, int parcial){
+    if(codigo == VSUM) return (int) ((unsigned) resultado + (unsigned) parcial);
+    if(codigo == VMIN) return (parcial < resultado) ? parcial : resultado;
+    return (parcial > resultado) ? parcial : resultado;
+}
+
+int kernelReducaoEscalar(int codigo, const int *valores, int quantidade){
+    int resultado = (codigo == VSUM) ? 0 : (codigo == VMIN) ? INT_MAX : INT_MIN;
+
+    for(int i = 0; i < quantidade; i++)
+        resultado = combinarReducao(codigo, resultado, valores[i]);
+
+    return resultado;
+}
+
+void kernelAritmeticoEscalar(int codigo, int *registradores, const int *operandos, int escalar, int quantidade){
+    // As operações são feitas sem sinal para que o estouro tenha o mesmo resultado (módulo 2^32) dos kernels SIMD.
+    unsigned *r = (unsigned *) registradores;
+
+    for(int i = 0; i < quantidade; i++){
+        unsigned valor = operandos ? (unsigned) operandos[i] : (unsigned) escalar;
+        if(codigo == ADD) r[i] += valor;
+        else if(codigo == SUB) r[i] -= valor;
+        else r[i] *= valor;
+    }
+}
+
+#ifdef SIMD_X86
+__attribute__((target("sse4.1")))
+void kernelAritmeticoSse41(int codigo, int *registradores, const int *operandos, int escalar, int quantidade){
+    __m128i registrador, operando = _mm_set1_epi32(escalar);
+    int i;
+
+    for(i = 0; i + 4 <= quantidade; i += 4){
+        registrador = _mm_loadu_si128((__m128i *) &registradores[i]);
+        if(operandos) operando = _mm_loadu_si128((const __m128i *) &operandos[i]);
+
+        if(codigo == ADD) registrador = _mm_add_epi32(registrador, operando);
+        else if(codigo == SUB) registrador = _mm_sub_epi32(registrador, operando);
+        else registrador = _mm_mullo_epi32(registrador, operando);
+
+        _mm_storeu_si128((__m128i *) &registradores[i], registrador);
+    }
+
+    kernelAritmeticoEscalar(codigo, &registradores[i], operandos ? &operandos[i] : NULL, escalar, quantidade - i);
+}
+
+__attribute__((target("avx2")))
+void kernelAritmeticoAvx2(int codigo, int *registradores, const int *operandos, int escalar, int quantidade){
+    __m256i registrador, operando = _mm256_set1_epi32(escalar);
+    int i;
+
+    for(i = 0; i + 8 <= quantidade; i += 8){
+        registrador = _mm256_loadu_si256((__m256i *) &registradores[i]);
+        if(operandos) operando = _mm256_loadu_si256((const __m256i *) &operandos[i]);
+
+        if(codigo == ADD) registrador = _mm256_add_epi32(registrador, operando);
+        else if(codigo == SUB) registrador = _mm256_sub_epi32(registrador, operando);
+        else registrador = _mm256_mullo_epi32(registrador, operando);
+
+        _mm256_storeu_si256((__m256i *) &registradores[i], registrador);
+    }
+
+    kernelAritmeticoEscalar(codigo, &registradores[i], operandos ? &operandos[i] : NULL, escalar, quantidade - i);
+}
+
+__attribute__((target("sse4.1")))
+int kernelReducaoSse41(int codigo, const int *valores, int quantidade){
+    __m128i acumulador, valor;
+    int parciais[4], i;
+
+    if(quantidade < 4)
+        return kernelReducaoEscalar(codigo, valores, quantidade);
+
+    acumulador = _mm_loadu_si128((const __m128i *) valores);
+    for(i = 4; i + 4 <= quantidade; i += 4){
+        valor = _mm_loadu_si128((const __m128i *) &valores[i]);
+
+        if(codigo == VSUM) acumulador = _mm_add_epi32(acumulador, valor);
+        else if(codigo == VMIN) acumulador = _mm_min_epi32(acumulador, valor);
+        else acumulador = _mm_max_epi32(acumulador, valor);
     }
+
+    // As lanes do acumulador e os elementos restantes são combinados pelo kernel escalar.
+    _mm_storeu_si128((__m128i *) parciais, acumulador);
+    return combinarReducao(codigo, kernelReducaoEscalar(codigo, parciais, 4), kernelReducaoEscalar(codigo, &valores[i], quantidade - i));
 }
 
-int verificarEstadoTarefas(DescritorTarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS], unsigned short quantidade, EstadoTarefa estado){
-    for(int index = 0; index < quantidade; index++)
-        if(tarefas[index].estado == estado)
-            return index;
+__attribute__((target("avx2")))
+int kernelReducaoAvx2(int codigo, const int *valores, int quantidade){
+    __m256i acumulador, valor;
+    int parciais[8], i;
 
-    return NAO_ENCONTRADO;
+    if(quantidade < 8)
+        return kernelReducaoSse41(codigo, valores, quantidade);
+
+    acumulador = _mm256_loadu_si256((const __m256i *) valores);
+    for(i = 8; i + 8 <= quantidade; i += 8){
+        valor = _mm256_loadu_si256((const __m256i *) &valores[i]);
+
+        if(codigo == VSUM) acumulador = _mm256_add_epi32(acumulador, valor);
+        else if(codigo == VMIN) acumulador = _mm256_min_epi32(acumulador, valor);
+        else acumulador = _mm256_max_epi32(acumulador, valor);
+    }
+
+    _mm256_storeu_si256((__m256i *) parciais, acumulador);
+    return combinarReducao(codigo, kernelReducaoEscalar(codigo, parciais, 8), kernelReducaoEscalar(codigo, &valores[i], quantidade - i));
+}
+#else
+void kernelAritmeticoSse41(int codigo, int *registradores, const int *operandos, int escalar, int quantidade){
+    kernelAritmeticoEscalar(codigo, registradores, operandos, escalar, quantidade);
 }
 
-int haTarefasAptas(DescritorTarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS], unsigned short quantidade){
-    int cont = 0;
-    for(int index = 0; index < quantidade; index++)
-        if(tarefas[index].estado != TERMINADA)
-            cont++;
+void kernelAritmeticoAvx2(int codigo, int *registradores, const int *operandos, int escalar, int quantidade){
+    kernelAritmeticoEscalar(codigo, registradores, operandos, escalar, quantidade);
+}
 
-    return (cont > 0) ? TRUE : FALSE;
+int kernelReducaoSse41(int codigo, const int *valores, int quantidade){
+    return kernelReducaoEscalar(codigo, valores, quantidade);
 }
 
-void escalonarProximaTarefaDaFila(MaquinaExecucao *maquina, unsigned short *indexFila){
-    for(int i = 0; i < maquina->numeroDeProgramas; i++){
-        if(maquina->df[*indexFila].estado == PRONTA){
-            maquina->df[*indexFila].estado = EXECUTANDO;
-            carregarContextoParaMaquina(*indexFila, maquina);
+int kernelReducaoAvx2(int codigo, const int *valores, int quantidade){
+    return kernelReducaoEscalar(codigo, valores, quantidade);
+}
+#endif
+
+void exibirSaidasLote(ProgramaDecodificado *programa, LoteInstancias *lote, Programa *fonte, unsigned long primeiraLinha){
+    unsigned short escritas;
+
+    for(int i = 0; i < lote->quantidadeInstancias; i++){
+        // Uma instância com erro exibe somente as escritas executadas antes da instrução que falhou.
+        escritas = programa->quantidadeEscritas;
+        if(lote->erros[i] != EXECUCAO_BEM_SUCEDIDA){
+            escritas = 0;
+            for(unsigned short pc = 0; pc < lote->pcErro[i] - 1; pc++)
+                if(programa->instrucoes[pc].codigo == WRITE) escritas++;
+        }
+
+        for(unsigned short escrita = 0; escrita < escritas; escrita++)
+            printf("%s[%lu] -> %s: %d\n", fonte->nome, primeiraLinha + i, INST_WRITE, lote->saidas[escrita * INSTANCIAS_POR_BLOCO + i]);
+
+        if(lote->erros[i] != EXECUCAO_BEM_SUCEDIDA)
+            imprimirErroLinha(stdout, fonte->nome, primeiraLinha + i, geradorDeErrosLpas(fonte->linhas[lote->pcErro[i] - 1], fonte->instrucoes[lote->pcErro[i] - 1], fonte->nome, lote->erros[i]));
+    }
+}
+
+void imprimirErroLinha(FILE *arquivo, const char *nome, unsigned long linha, ErroExecucao erro){
+    fprintf(arquivo, "%s[%lu] -> ERRO - %d (Instrução: %s, Linha: %d)\n", nome, linha, erro.erro, erro.instrucao, erro.numeroLinha);
+}
+
+int executarModoMap(const char *nomePrograma, const char *arquivoEntradas, const char *arquivoSaida){
+    Tarefa tarefa;
+    FilaMap fila;
+    FILE *saida = stdout;
+    pthread_t leitura, *threads;
+    long quantidadeThreads = sysconf(_SC_NPROCESSORS_ONLN), criadas;
+    unsigned long totalLinhas = 0;
+    long long inicio = obterTempoNs();
+    BlocoMap *bloco;
+
+    snprintf(tarefa.nome, TAMANHO_NOME_ARQUIVO, "%s", nomePrograma);
+    if(!carregarTarefas(&tarefa, 1))
+        return EXIT_FAILURE;
+
+    // Cada linha guarda somente os valores consumidos pelos READs do programa.
+    if(tarefa.imagem->codigo.quantidadeLeituras > MAXIMO_ENTRADAS_EXECUCAO){
+        printf(ERRO_LEITURAS_EXCEDIDAS, tarefa.nome, tarefa.imagem->codigo.quantidadeLeituras, MAXIMO_ENTRADAS_EXECUCAO);
+        liberarImagemPrograma(tarefa.imagem);
+        return EXIT_FAILURE;
+    }
+
+    if(!(fila.arquivo = fopen(arquivoEntradas, APENAS_LEITURA))){
+        printf(ERRO_ARQUIVO_NAO_EXISTE, arquivoEntradas);
+        liberarImagemPrograma(tarefa.imagem);
+        return EXIT_FAILURE;
+    }
+
+    if(arquivoSaida && !(saida = fopen(arquivoSaida, "w"))){
+        printf(ERRO_ARQUIVO_NAO_EXISTE, arquivoSaida);
+        fclose(fila.arquivo);
+        liberarImagemPrograma(tarefa.imagem);
+        return EXIT_FAILURE;
+    }
+
+    if(quantidadeThreads < 1) quantidadeThreads = 1;
+
+    // Dois blocos por thread: enquanto um é executado o próximo já pode ser lido.
+    fila.tarefa = &tarefa;
+    fila.quantidadeBlocos = 2 * quantidadeThreads + 1;
+    fila.blocos = calloc(fila.quantidadeBlocos, sizeof(BlocoMap));
+    threads = malloc(quantidadeThreads * sizeof(pthread_t));
+    fila.proximoExecutar = fila.totalBlocos = 0;
+    fila.fimLeitura = FALSE;
+    pthread_mutex_init(&fila.trava, NULL);
+    pthread_cond_init(&fila.mudouEstado, NULL);
+
+    for(int i = 0; fila.blocos && i < fila.quantidadeBlocos; i++){
+        fila.blocos[i].colunasPorLinha = (tarefa.imagem->codigo.quantidadeLeituras > 0) ? tarefa.imagem->codigo.quantidadeLeituras : 1;
+        if(!(fila.blocos[i].valores = malloc(LINHAS_POR_BLOCO_MAP * fila.blocos[i].colunasPorLinha * sizeof(int))))
+            fila.quantidadeBlocos = 0;
+    }
+
+    if(!fila.blocos || !threads || fila.quantidadeBlocos == 0){
+        printf(ERRO_MEMORIA_INSUFICIENTE);
+        exit(EXIT_FAILURE);
+    }
+
+    // Como na carga dos programas, o modo map continua com as threads que puderam ser criadas.
+    for(criadas = 0; criadas < quantidadeThreads; criadas++)
+        if(pthread_create(&threads[criadas], NULL, executarBlocosMap, &fila) != 0)
             break;
-        } else
-            if(++(*indexFila) == maquina->numeroDeProgramas) *indexFila = 0;
+    quantidadeThreads = criadas;
+
+    if(quantidadeThreads == 0 || pthread_create(&leitura, NULL, lerBlocosMap, &fila) != 0){
+        // Sem a leitura, as threads de execução encontram a fila encerrada e vazia.
+        pthread_mutex_lock(&fila.trava);
+        fila.fimLeitura = TRUE;
+        pthread_cond_broadcast(&fila.mudouEstado);
+        pthread_mutex_unlock(&fila.trava);
+        for(long i = 0; i < quantidadeThreads; i++)
+            pthread_join(threads[i], NULL);
+
+        printf(ERRO_THREADS_MAP);
+        exit(EXIT_FAILURE);
+    }
+
+    // A thread principal escreve os blocos concluídos na ordem em que foram lidos.
+    for(unsigned long sequencia = 0; ; sequencia++){
+        bloco = &fila.blocos[sequencia % fila.quantidadeBlocos];
+
+        pthread_mutex_lock(&fila.trava);
+        while(bloco->estado != BLOCO_CONCLUIDO && !(fila.fimLeitura && sequencia >= fila.totalBlocos))
+            pthread_cond_wait(&fila.mudouEstado, &fila.trava);
+        pthread_mutex_unlock(&fila.trava);
+
+        if(bloco->estado != BLOCO_CONCLUIDO) break;
+
+        fwrite(bloco->saida, 1, bloco->tamanhoSaida, saida);
+        free(bloco->saida);
+        totalLinhas += bloco->quantidadeLinhas;
+
+        pthread_mutex_lock(&fila.trava);
+        bloco->estado = BLOCO_LIVRE;
+        pthread_cond_broadcast(&fila.mudouEstado);
+        pthread_mutex_unlock(&fila.trava);
+    }
+
+    pthread_join(leitura, NULL);
+    for(long i = 0; i < quantidadeThreads; i++)
+        pthread_join(threads[i], NULL);
+
+    if(saida != stdout) fclose(saida);
+
+    printf("\n- Modo map (%ld threads, código %s)", quantidadeThreads, tarefa.imagem->codigo.nativo ? "nativo" : "interpretado");
+    printf("\n\tLinhas executadas = %lu", totalLinhas);
+    printf("\n\tTempo total = %.3f ms", (obterTempoNs() - inicio) / 1000000.0);
+    printf("\n\tLinhas por segundo = %.0f\n\n", totalLinhas * 1000000000.0 / (obterTempoNs() - inicio));
+
+    if(cacheResultados){
+        exibirMemoizacao();
+        printf("\n\n");
     }
+
+    for(int i = 0; i < fila.quantidadeBlocos; i++)
+        free(fila.blocos[i].valores);
+    free(fila.blocos);
+    free(threads);
+    fclose(fila.arquivo);
+    pthread_mutex_destroy(&fila.trava);
+    pthread_cond_destroy(&fila.mudouEstado);
+    liberarImagemPrograma(tarefa.imagem);
+
+    return EXIT_SUCCESS;
 }
 
-void gerarPreempcaoPorTempo(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short *indexFila){
-    maquina->df[*indexFila].estado = PRONTA;
-    salvarContextoDaMaquina(*indexFila, maquina);
-    if(++(*indexFila) == maquina->numeroDeProgramas) *indexFila = 0;
-    roudRobin->contadorPreempcao = 1;
+void * lerBlocosMap(void *argumento){
+    FilaMap *fila = argumento;
+    BlocoMap *bloco;
+    unsigned long sequencia, linha = 1;
+    int colunas;
+
+    for(sequencia = 0; ; sequencia++){
+        bloco = &fila->blocos[sequencia % fila->quantidadeBlocos];
+
+        // Aguarda a escrita liberar o bloco.
+        pthread_mutex_lock(&fila->trava);
+        while(bloco->estado != BLOCO_LIVRE)
+            pthread_cond_wait(&fila->mudouEstado, &fila->trava);
+        pthread_mutex_unlock(&fila->trava);
+
+        bloco->primeiraLinha = linha;
+        for(bloco->quantidadeLinhas = 0; bloco->quantidadeLinhas < LINHAS_POR_BLOCO_MAP; bloco->quantidadeLinhas++){
+            colunas = lerLinhaEntradas(fila->arquivo, &bloco->valores[bloco->quantidadeLinhas * bloco->colunasPorLinha], bloco->colunasPorLinha);
+            if(colunas == NAO_ENCONTRADO) break;
+            bloco->colunas[bloco->quantidadeLinhas] = colunas;
+        }
+        linha += bloco->quantidadeLinhas;
+
+        pthread_mutex_lock(&fila->trava);
+        if(bloco->quantidadeLinhas > 0)
+            bloco->estado = BLOCO_LIDO;
+        if(bloco->quantidadeLinhas < LINHAS_POR_BLOCO_MAP){
+            fila->fimLeitura = TRUE;
+            fila->totalBlocos = sequencia + (bloco->quantidadeLinhas > 0);
+        }
+        pthread_cond_broadcast(&fila->mudouEstado);
+        pthread_mutex_unlock(&fila->trava);
+
+        if(fila->fimLeitura) break;
+    }
+
+    return NULL;
 }
 
-void terminarTarefa(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short indexFila){
-    maquina->df[indexFila].estado = TERMINADA;
-    roudRobin->contadorPreempcao = 1;
-    roudRobin->tempoEntradaESaidaFila[indexFila][1] = roudRobin->contadorCPU + 1;
+void * executarBlocosMap(void *argumento){
+    FilaMap *fila = argumento;
+    BlocoMap *bloco;
+
+    while(TRUE){
+        // Obtém o próximo bloco, na ordem de leitura.
+        pthread_mutex_lock(&fila->trava);
+        while(TRUE){
+            bloco = &fila->blocos[fila->proximoExecutar % fila->quantidadeBlocos];
+            if(bloco->estado == BLOCO_LIDO || (fila->fimLeitura && fila->proximoExecutar >= fila->totalBlocos))
+                break;
+            pthread_cond_wait(&fila->mudouEstado, &fila->trava);
+        }
+
+        if(bloco->estado != BLOCO_LIDO){
+            pthread_mutex_unlock(&fila->trava);
+            break;
+        }
+
+        bloco->estado = BLOCO_EXECUTANDO;
+        fila->proximoExecutar++;
+        pthread_mutex_unlock(&fila->trava);
+
+        executarBlocoMap(fila->tarefa, bloco);
+
+        pthread_mutex_lock(&fila->trava);
+        bloco->estado = BLOCO_CONCLUIDO;
+        pthread_cond_broadcast(&fila->mudouEstado);
+        pthread_mutex_unlock(&fila->trava);
+    }
+
+    return NULL;
+}
+
+void executarBlocoMap(Tarefa *tarefa, BlocoMap *bloco){
+    MaquinaExecucao maquina;
+    Tarefa copia = *tarefa; // inicializarMaquinaExecucao altera a tarefa, que é compartilhada entre as threads.
+    FILE *saida = open_memstream(&bloco->saida, &bloco->tamanhoSaida);
+    ResultadoMemoizado memoizado;
+    int resultado, memoizavel, quantidadeLeituras = copia.imagem->codigo.quantidadeLeituras, acertos = 0;
+
+    inicializarMaquinaExecucao(&copia, 1, &maquina);
+    inicializarContextos(1, &maquina);
+    carregarContextoParaMaquina(0, &maquina);
+    maquina.lote.saida = saida;
+
+    for(int i = 0; i < bloco->quantidadeLinhas; i++){
+        // Cada linha é uma nova execução da tarefa: reinicia o contexto e associa as entradas da linha.
+        maquina.df[0].pc = 0;
+        maquina.df[0].ciclosPendentes = 0;
+        maquina.registrador = 0;
+        maquina.lote.entradas = &bloco->valores[i * bloco->colunasPorLinha];
+        maquina.lote.quantidadeEntradas = bloco->colunas[i];
+        maquina.lote.proximaEntrada = 0;
+        maquina.lote.linha = bloco->primeiraLinha + i;
+
+        // Linhas com as mesmas entradas (as consumidas pelos READs) repetem o resultado guardado no cache, sem executar o programa.
+        /* Sem nenhum acerto na amostra do início do bloco, as entradas do bloco não se repetem: consultar e guardar cada linha custaria
+           mais que executá-la, então o restante do bloco não usa o cache. */
+        memoizavel = cacheResultados && (i < AMOSTRA_MEMO_MAP || acertos) && quantidadeLeituras <= MAXIMO_ENTRADAS_MEMO && copia.imagem->codigo.quantidadeEscritas <= MAXIMO_ESCRITAS_MEMO
+                     && !copia.imagem->codigo.quantidadeInstrucoesVetor && bloco->colunas[i] >= quantidadeLeituras;
+        if(memoizavel && consultarCacheResultados(&copia.imagem->codigo, maquina.lote.entradas, quantidadeLeituras, &memoizado)){
+            acertos++;
+            for(int escrita = 0; escrita < memoizado.quantidadeEscritas; escrita++)
+                fprintf(saida, "%s[%lu] -> %s: %d\n", tarefa->nome, maquina.lote.linha, INST_WRITE, memoizado.escritas[escrita]);
+            continue;
+        }
+        copia.resultado.quantidadeEscritas = 0;
+
+        // O código nativo executa até a próxima instrução que precisa do interpretador (READ, WRITE, HALT ou DIV por 0).
+        do{
+            if(copia.imagem->codigo.nativo)
+                copia.imagem->codigo.nativo(&maquina.registrador, maquina.variaveis, &maquina.df[0].pc, UINT_MAX);
+            resultado = interpretador(0, &maquina);
+        } while(resultado == RETURN_OK);
+
+        if(resultado == RETURN_ERRO)
+            imprimirErroLinha(saida, tarefa->nome, maquina.lote.linha, maquina.erroExecucao);
+        else if(memoizavel){
+            // O modo map não contabiliza ut: sem desvios no LPAS, a execução completa passa por todas as instruções.
+            copia.resultado.tempoCPU = copia.imagem->codigo.numeroDeInstrucoes;
+            copia.resultado.tempoES = quantidadeLeituras * READ_TIME;
+            guardarCacheResultados(&copia.imagem->codigo, maquina.lote.entradas, quantidadeLeituras, &copia.resultado);
+        }
+    }
+
+    free(maquina.df[0].variaveis);
+    fclose(saida);
+}
+
+int executarModoServidor(const char *caminho, int concorrencia){
+    struct sockaddr_un endereco;
+    int servidor, cliente, vaga, ativos = 0;
+    pid_t pid, *vagas;
+    HistogramasLatencia *latencias;
+
+    if(strlen(caminho) >= sizeof(endereco.sun_path) || (servidor = socket(AF_UNIX, SOCK_STREAM, 0)) < 0){
+        printf(ERRO_SOCKET, caminho);
+        return EXIT_FAILURE;
+    }
+
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminho);
+    unlink(caminho); // Remove o socket deixado por uma execução anterior.
+
+    if(bind(servidor, (struct sockaddr *) &endereco, sizeof(endereco)) < 0 || listen(servidor, SOMAXCONN) < 0){
+        printf(ERRO_SOCKET, caminho);
+        close(servidor);
+        return EXIT_FAILURE;
+    }
+
+    // Um cliente que encerra a conexão antes do fim do trabalho não deve derrubar o processo que o executa.
+    signal(SIGPIPE, SIG_IGN);
+
+    // Cada trabalho ocupa uma vaga; com afinidade, a vaga define os núcleos dos seus processos tes.
+    if(!(vagas = calloc(concorrencia, sizeof(pid_t)))){
+        printf(ERRO_MEMORIA_INSUFICIENTE);
+        close(servidor);
+        return EXIT_FAILURE;
+    }
+
+    // As latências de todos os trabalhos são acumuladas em uma distribuição compartilhada com os processos que os executam.
+    latencias = criarHistogramasCompartilhados();
+
+    printf(MSG_SERVIDOR, caminho, concorrencia);
+
+    while(TRUE){
+        // Recolhe os trabalhos encerrados; no limite de concorrência, aguarda um deles terminar (os novos pedidos aguardam na fila do socket).
+        while(ativos > 0 && (pid = waitpid(-1, NULL, (ativos >= concorrencia) ? 0 : WNOHANG)) > 0){
+            for(vaga = 0; vaga < concorrencia; vaga++)
+                if(vagas[vaga] == pid) vagas[vaga] = 0;
+            ativos--;
+        }
+
+        if((cliente = accept(servidor, NULL, NULL)) < 0)
+            continue;
+
+        for(vaga = 0; vaga < concorrencia && vagas[vaga]; vaga++);
+
+        if((pid = criarProcesso()) == 0){
+            close(servidor);
+            atenderCliente(cliente, vaga, latencias);
+        }
+
+        // Uma falha transitória (ex.: EAGAIN) recusa somente este pedido; o servidor continua atendendo.
+        if(pid < 0)
+            dprintf(cliente, ERRO_CRIAR_TRABALHO, strerror(errno));
+
+        close(cliente);
+        if(pid > 0){
+            vagas[vaga] = pid;
+            ativos++;
+        }
+    }
+}
+
+void atenderCliente(int cliente, int vaga, HistogramasLatencia *latenciasServidor){
+    Tarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS];
+    int entradas[NUMERO_MAXIMO_DE_PROGRAMAS][MAXIMO_ENTRADAS_EXECUCAO];
+    unsigned short quantidadeProgramas;
+    HistogramasLatencia *latencias;
+    FILE *entrada = fdopen(cliente, APENAS_LEITURA);
+
+    // As mensagens, as escritas (WRITE) e os relatórios dos processos tes são enviados ao cliente, linha a linha, durante a execução.
+    dup2(cliente, STDOUT_FILENO);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    deslocamentoAfinidade = vaga * NUMERO_MAXIMO_DE_PROCESSOS;
+
+    if(entrada){
+        quantidadeProgramas = lerPedido(entrada, tarefas, entradas);
+
+        if(quantidadeProgramas > 0){
+            // Como em um comando do prompt, os processos tes do trabalho acumulam as suas latências na mesma distribuição.
+            latencias = criarHistogramasCompartilhados();
+            executarProgramas(tarefas, quantidadeProgramas, latencias);
+
+            if(latencias){
+                exibirLatenciasCombinadas(TITULO_LATENCIAS_PROCESSOS, latencias);
+                if(latenciasServidor){
+                    combinarHistogramas(latenciasServidor, latencias);
+                    exibirLatenciasCombinadas(TITULO_LATENCIAS_SERVIDOR, latenciasServidor);
+                }
+                destruirHistogramasCompartilhados(latencias);
+            }
+        }
+
+        if(cacheResultados){
+            exibirMemoizacao();
+            printf("\n\n");
+        }
+    }
+
+    encerrarProcessoFilho(EXIT_SUCCESS);
+}
+
+unsigned short lerPedido(FILE *entrada, Tarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS], int entradas[NUMERO_MAXIMO_DE_PROGRAMAS][MAXIMO_ENTRADAS_EXECUCAO]){
+    char linha[TAMANHO_LINHA_PEDIDO], nomeArquivo[TAMANHO_NOME_ARQUIVO + sizeof(EXTENSAO_LPAS)], *comando, *nome, *valor, *contexto, *fonte;
+    unsigned short quantidadeProgramas = 0;
+    size_t tamanhoFonte;
+    Programa programa;
+    ErroExecucao erro;
+    FILE *arquivo;
+    Tarefa *tarefa;
+
+    while(fgets(linha, sizeof(linha), entrada)){
+        linha[strcspn(linha, "\r\n")] = CHAR_NULO;
+
+        if(!(comando = strtok_r(linha, DELIMITADOR, &contexto)))
+            continue;
+
+        if(!strcmp(comando, COMANDO_EXECUTAR))
+            break;
+
+        // O nome não pode conter diretórios: somente os programas do diretório do servidor podem ser executados.
+        nome = strtok_r(NULL, DELIMITADOR, &contexto);
+        tarefa = &tarefas[quantidadeProgramas];
+        if((strcmp(comando, COMANDO_PROGRAMA) && strcmp(comando, COMANDO_FONTE)) || !nome || strlen(nome) >= TAMANHO_NOME_ARQUIVO || strchr(nome, '/')
+            || quantidadeProgramas == NUMERO_MAXIMO_DE_PROGRAMAS || !separarChegada(nome, &tarefa->chegada)){
+            printf(ERRO_PEDIDO_INVALIDO, comando);
+            return 0;
+        }
+
+        strcpy(tarefa->nome, nome);
+        strcpy(programa.nome, nome);
+        tarefa->memoizada = FALSE;
+
+        // Valores consumidos pelos READs da tarefa.
+        tarefa->entradas = entradas[quantidadeProgramas];
+        tarefa->quantidadeEntradas = tarefa->proximaEntrada = 0;
+        while((valor = strtok_r(NULL, DELIMITADOR, &contexto))){
+            if(tarefa->quantidadeEntradas == MAXIMO_ENTRADAS_EXECUCAO || !converterNumero(valor, &tarefa->entradas[tarefa->quantidadeEntradas])){
+                printf(ERRO_PEDIDO_INVALIDO, valor);
+                return 0;
+            }
+            tarefa->quantidadeEntradas++;
+        }
+
+        if(!strcmp(comando, COMANDO_PROGRAMA)){
+            snprintf(nomeArquivo, sizeof(nomeArquivo), "%s%s", nome, EXTENSAO_LPAS);
+            if(!(arquivo = fopen(nomeArquivo, APENAS_LEITURA))){
+                printf(ERRO_PROGRAMA_NAO_EXISTE, nomeArquivo);
+                continue;
+            }
+            programa.numeroDeInstrucoes = lerInstrucoesDoArquivo(&programa, arquivo);
+            fclose(arquivo);
+        } else {
+            // O código enviado é acumulado até a linha FIM e lido como um arquivo LPAS.
+            fonte = NULL;
+            if(!(arquivo = open_memstream(&fonte, &tamanhoFonte))){
+                printf(ERRO_MEMORIA_INSUFICIENTE);
+                return 0;
+            }
+            while(fgets(linha, sizeof(linha), entrada)){
+                if(!strncmp(linha, COMANDO_FIM_FONTE, strlen(COMANDO_FIM_FONTE)) && strchr("\r\n", linha[strlen(COMANDO_FIM_FONTE)]))
+                    break;
+                fputs(linha, arquivo);
+            }
+            fclose(arquivo);
+
+            programa.numeroDeInstrucoes = 0;
+            if(tamanhoFonte > 0 && (arquivo = fmemopen(fonte, tamanhoFonte, APENAS_LEITURA))){
+                programa.numeroDeInstrucoes = lerInstrucoesDoArquivo(&programa, arquivo);
+                fclose(arquivo);
+            }
+            free(fonte);
+        }
+
+        // Os programas inválidos são descartados; os pedidos com o mesmo código compartilham a imagem.
+        if(!(tarefa->imagem = obterImagemPrograma(&programa, &erro))){
+            imprimirDadosErro(erro);
+            continue;
+        }
+
+        // Um programa que lê mais valores do que um pedido pode enviar falharia sempre no READ.
+        if(tarefa->imagem->codigo.quantidadeLeituras > MAXIMO_ENTRADAS_EXECUCAO){
+            printf(ERRO_LEITURAS_EXCEDIDAS, nome, tarefa->imagem->codigo.quantidadeLeituras, MAXIMO_ENTRADAS_EXECUCAO);
+            liberarImagemPrograma(tarefa->imagem);
+            continue;
+        }
+
+        quantidadeProgramas++;
+    }
+
+    return quantidadeProgramas;
 }
 
 void imprimirDadosErro(ErroExecucao erro){
@@ -491,36 +3225,321 @@ void imprimirDadosErro(ErroExecucao erro){
     printf("\n\tLinha    : %d\n", erro.numeroLinha);
 }
 
-void exibirRelatorioProcesso(MaquinaExecucao maquina, RoundRobin roudRobin, unsigned short quantidadeProgramas, unsigned short tes){
-    int tempoMedioExecucao = 0, tempoMedioEspera = 0;
+void exibirRelatorioProcesso(MaquinaExecucao maquina, RoundRobin roudRobin, unsigned short quantidadeProgramas, unsigned short tes, HistogramasLatencia *latencias){
+    int tempoMedioExecucao = 0, tempoMedioEspera = 0, quantidadeExecutadas = 0;
+    UnidadeTempo tempoCPU, tempoES;
     printf("\n\n- Processo tes%d", tes);
 
     for(int index = 0; index < quantidadeProgramas; index++) {
-        printf("\n\n\t- Tarefa: %s%s", maquina.df[index].tarefa.programa.nome, EXTENSAO_LPAS);
-        printf("\n\tTempo de CPU = %d ut", maquina.df[index].tempoCPU);
-        printf("\n\tTempo de E/S = %d ut", maquina.df[index].tempoES);
-        printf("\n\tTaxa de ocupação da CPU = %.2f%%", (float) maquina.df[index].tempoCPU / roudRobin.contadorCPU * 100);
+        // As tarefas migradas são exibidas no relatório do processo que as executou.
+        if(maquina.df[index].migrada){
+            printf("\n\n\t- Tarefa: %s%s (migrada)", maquina.df[index].tarefa->nome, EXTENSAO_LPAS);
+            continue;
+        }
+
+        quantidadeExecutadas++;
+        printf("\n\n\t- Tarefa: %s%s%s", maquina.df[index].tarefa->nome, EXTENSAO_LPAS,
+               maquina.df[index].abortada ? " (abortada: limite excedido)" : maquina.df[index].tarefa->memoizada ? " (memoizada)" : "");
+        if(maquina.df[index].tarefa->chegada)
+            printf("\n\tChegada = %u ut (admitida em %u ut)", maquina.df[index].tarefa->chegada, roudRobin.admissao[index]);
+        if(configuracao.diretorioNativo)
+            printf("\n\tCódigo = %s", maquina.df[index].tarefa->imagem->codigo.nativo ? "nativo" : "interpretado");
+
+        // Uma tarefa recebida por migração é medida somente pelo tempo neste processo; o total inclui o consumido na origem.
+        tempoCPU = maquina.df[index].tempoCPU - roudRobin.tempoAnterior[index][0];
+        tempoES = maquina.df[index].tempoES - roudRobin.tempoAnterior[index][1];
+        if(roudRobin.tempoAnterior[index][0] || roudRobin.tempoAnterior[index][1]){
+            printf("\n\tTempo de CPU = %d ut (%u ut neste processo)", maquina.df[index].tempoCPU, tempoCPU);
+            printf("\n\tTempo de E/S = %u ut (%u ut neste processo)", maquina.df[index].tempoES, tempoES);
+        } else {
+            printf("\n\tTempo de CPU = %d ut", maquina.df[index].tempoCPU);
+            printf("\n\tTempo de E/S = %u ut", maquina.df[index].tempoES);
+        }
+        printf("\n\tTaxa de ocupação da CPU = %.2f%%", (float) tempoCPU / roudRobin.contadorCPU * 100);
+        if(roudRobin.grupoContadores.descritores[CONTADOR_CICLOS] >= 0)
+            exibirContadoresHardware(&roudRobin.grupoContadores, &roudRobin.contadores[index], roudRobin.contadores[index].instrucoesLpas, "instrução LPAS");
 
-        tempoMedioEspera += roudRobin.tempoEntradaESaidaFila[index][1] - roudRobin.tempoEntradaESaidaFila[index][0] - maquina.df[index].tempoCPU;
+        // Com E/S bloqueante, o tempo suspenso não é tempo de espera na fila.
+        tempoMedioEspera += calcularTempoEspera(&maquina, &roudRobin, index);
         tempoMedioExecucao += roudRobin.tempoEntradaESaidaFila[index][1] - roudRobin.tempoEntradaESaidaFila[index][0];
     }
 
     printf("\n\n\t- Round-Robin");
-    printf("\n\tTempo médio de execução = %.2f ut", (float) tempoMedioExecucao / quantidadeProgramas);
-    printf("\n\tTempo médio de espera = %.2f ut", (float) tempoMedioEspera / quantidadeProgramas);
+    printf("\n\tTempo médio de execução = %.2f ut", quantidadeExecutadas ? (float) tempoMedioExecucao / quantidadeExecutadas : 0);
+    printf("\n\tTempo médio de espera = %.2f ut", quantidadeExecutadas ? (float) tempoMedioEspera / quantidadeExecutadas : 0);
+
+    // Sem E/S bloqueante, a CPU só fica ociosa aguardando a chegada de uma tarefa.
+    if(!maquina.latenciaES && roudRobin.tempoOcioso)
+        printf("\n\tTempo ocioso da CPU = %u ut", roudRobin.tempoOcioso);
+
+    if(quantidadeExecutadas > 0)
+        exibirLatencias(latencias);
+
+    if(maquina.latenciaES){
+        printf("\n\n\t- E/S bloqueante (%u ut por READ)", maquina.latenciaES);
+        printf("\n\tTempo total = %u ut", roudRobin.contadorCPU);
+        printf("\n\tTempo ocioso da CPU = %u ut", roudRobin.tempoOcioso);
+        printf("\n\tVoltas do escalonador = %lu (%s)", roudRobin.iteracoes, configuracao.eventos ? "avanço por eventos" : "1 ut por volta");
+    }
+
+    if(configuracao.gantt && roudRobin.eventos.eventos)
+        exibirGantt(&roudRobin.eventos, &maquina, roudRobin.contadorCPU);
+
+    if(configuracao.afinidade)
+        exibirProcessador();
+
+    if(configuracao.migracao){
+        printf("\n\n\t- Migração");
+        printf("\n\tTarefas enviadas = %d", roudRobin.migracoesEnviadas);
+        printf("\n\tTarefas recebidas = %d", roudRobin.migracoesRecebidas);
+        printf("\n\tCusto de migração = %.3f us", roudRobin.custoMigracaoNs / 1000.0);
+        printf("\n\tTempo ocioso aguardando migração = %.3f ms", roudRobin.esperaMigracaoNs / 1000000.0);
+    }
+
+    // Fora da execução das tarefas: escalonamento, admissões, despertares e migrações, por volta do loop do escalonador.
+    if(configuracao.contadores){
+        printf("\n\n\t- Contadores de hardware do escalonador");
+        if(roudRobin.grupoContadores.descritores[CONTADOR_CICLOS] >= 0)
+            exibirContadoresHardware(&roudRobin.grupoContadores, &roudRobin.contadoresEscalonador, roudRobin.iteracoes, "volta");
+        else
+            printf("\n\tIndisponíveis neste processo");
+    }
 
     printf("\n\n");
 }
 
+int lerListaNucleos(const char *lista, cpu_set_t *conjunto){
+    char *fim;
+    long inicio, final;
+
+    while(*lista){
+        inicio = final = strtol(lista, &fim, 10);
+        if(fim == lista) return FALSE;
+
+        if(*fim == '-'){
+            lista = fim + 1;
+            final = strtol(lista, &fim, 10);
+            if(fim == lista) return FALSE;
+        }
+
+        if(inicio < 0 || final < inicio || final >= CPU_SETSIZE)
+            return FALSE;
+
+        for(long nucleo = inicio; nucleo <= final; nucleo++)
+            CPU_SET(nucleo, conjunto);
+
+        if(*fim == ',')
+            fim++;
+        else if(*fim != '\0' && *fim != '\n')
+            return FALSE;
+
+        lista = (*fim == '\n') ? fim + 1 : fim;
+    }
+
+    return TRUE;
+}
+
+void formatarListaNucleos(cpu_set_t *conjunto, char *lista, size_t tamanho){
+    size_t escrito = 0;
+    int inicio;
+
+    lista[0] = '\0';
+    for(int nucleo = 0; nucleo < CPU_SETSIZE && escrito < tamanho; nucleo++){
+        if(!CPU_ISSET(nucleo, conjunto))
+            continue;
+
+        // Núcleos consecutivos são agrupados em um intervalo.
+        for(inicio = nucleo; nucleo + 1 < CPU_SETSIZE && CPU_ISSET(nucleo + 1, conjunto); nucleo++);
+
+        if(inicio == nucleo)
+            escrito += snprintf(lista + escrito, tamanho - escrito, "%s%d", escrito ? "," : "", inicio);
+        else
+            escrito += snprintf(lista + escrito, tamanho - escrito, "%s%d-%d", escrito ? "," : "", inicio, nucleo);
+    }
+}
+
+void ordenarNucleos(cpu_set_t *conjunto, Configuracao *configuracao){
+    unsigned short posicao[CPU_SETSIZE];
+    char caminho[TAMANHO_CAMINHO_TOPOLOGIA], irmaos[TAMANHO_LISTA_NUCLEOS];
+    cpu_set_t conjuntoIrmaos;
+    int maiorPosicao = 0;
+    FILE *arquivo;
+
+    // A posição de um núcleo lógico entre os irmãos de hyperthread do seu núcleo físico (0 para o primeiro).
+    for(int nucleo = 0; nucleo < CPU_SETSIZE; nucleo++){
+        posicao[nucleo] = 0;
+        if(!CPU_ISSET(nucleo, conjunto))
+            continue;
+
+        snprintf(caminho, sizeof(caminho), CAMINHO_TOPOLOGIA_NUCLEO, nucleo);
+        CPU_ZERO(&conjuntoIrmaos);
+
+        if((arquivo = fopen(caminho, APENAS_LEITURA))){
+            if(fgets(irmaos, sizeof(irmaos), arquivo) && lerListaNucleos(irmaos, &conjuntoIrmaos))
+                for(int irmao = 0; irmao < nucleo; irmao++)
+                    if(CPU_ISSET(irmao, &conjuntoIrmaos)) posicao[nucleo]++;
+            fclose(arquivo);
+        }
+
+        if(posicao[nucleo] > maiorPosicao)
+            maiorPosicao = posicao[nucleo];
+    }
+
+    configuracao->quantidadeNucleos = 0;
+    for(int nivel = 0; nivel <= maiorPosicao; nivel++)
+        for(int nucleo = 0; nucleo < CPU_SETSIZE; nucleo++)
+            if(CPU_ISSET(nucleo, conjunto) && posicao[nucleo] == nivel)
+                configuracao->ordemNucleos[configuracao->quantidadeNucleos++] = nucleo;
+}
+
+void aplicarAfinidade(int indiceProcesso){
+    cpu_set_t conjunto;
+
+    CPU_ZERO(&conjunto);
+    if(configuracao.afinidadeCompartilhada){
+        for(int index = 0; index < configuracao.quantidadeNucleos; index++)
+            CPU_SET(configuracao.ordemNucleos[index], &conjunto);
+    }
+    else
+        CPU_SET(configuracao.ordemNucleos[indiceProcesso % configuracao.quantidadeNucleos], &conjunto);
+
+    // Uma falha mantém o processo nos núcleos herdados; o relatório exibe os núcleos efetivos.
+    sched_setaffinity(0, sizeof(conjunto), &conjunto);
+}
+
+void exibirProcessador(){
+    char lista[TAMANHO_LISTA_NUCLEOS];
+    cpu_set_t conjunto;
+    struct rusage uso;
+
+    printf("\n\n\t- Processador");
+
+    if(sched_getaffinity(0, sizeof(conjunto), &conjunto) == 0){
+        formatarListaNucleos(&conjunto, lista, sizeof(lista));
+        printf("\n\tNúcleos permitidos = %s", lista);
+    }
+    printf("\n\tNúcleo atual = %d", sched_getcpu());
+
+    // O processo tes é criado por fork, então o uso de recursos é apenas o da sua execução.
+    if(getrusage(RUSAGE_SELF, &uso) == 0){
+        printf("\n\tTrocas de contexto voluntárias = %ld", uso.ru_nvcsw);
+        printf("\n\tTrocas de contexto involuntárias = %ld", uso.ru_nivcsw);
+    }
+}
+
+int abrirContadoresHardware(GrupoContadores *grupo){
+    // Tipo e configuração de cada contador, na ordem de TipoContador. As falhas de cache são as das leituras de dados.
+    static const struct { unsigned tipo; unsigned long long configuracao; } eventos[QUANTIDADE_CONTADORES] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)}
+    };
+    struct perf_event_attr atributos;
+
+    for(int contador = 0; contador < QUANTIDADE_CONTADORES; contador++)
+        grupo->descritores[contador] = -1;
+    grupo->quantidade = 0;
+
+    for(int contador = 0; contador < QUANTIDADE_CONTADORES; contador++){
+        memset(&atributos, 0, sizeof(atributos));
+        atributos.size = sizeof(atributos);
+        atributos.type = eventos[contador].tipo;
+        atributos.config = eventos[contador].configuracao;
+        atributos.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        atributos.exclude_kernel = 1;
+        atributos.exclude_hv = 1;
+
+        // Somente a thread atual (pid 0), em qualquer núcleo (-1); os demais contadores entram no grupo dos ciclos.
+        grupo->descritores[contador] = syscall(SYS_perf_event_open, &atributos, 0, -1,
+                                               contador == CONTADOR_CICLOS ? -1 : grupo->descritores[CONTADOR_CICLOS], PERF_FLAG_FD_CLOEXEC);
+        if(grupo->descritores[contador] < 0){
+            if(contador == CONTADOR_CICLOS)
+                return FALSE;
+            continue;
+        }
+        grupo->posicao[contador] = grupo->quantidade++;
+    }
+
+    return TRUE;
+}
+
+int lerContadoresHardware(const GrupoContadores *grupo, unsigned long long valores[]){
+    // Formato da leitura do grupo: quantidade de contadores, tempo habilitado, tempo em execução e os valores na ordem de abertura.
+    unsigned long long leitura[3 + QUANTIDADE_CONTADORES];
+
+    if(read(grupo->descritores[CONTADOR_CICLOS], leitura, sizeof(leitura)) < (ssize_t) ((3 + grupo->quantidade) * sizeof(unsigned long long)))
+        return FALSE;
+
+    for(int contador = 0; contador < QUANTIDADE_CONTADORES; contador++){
+        valores[contador] = 0;
+        if(grupo->descritores[contador] < 0)
+            continue;
+
+        // Com o grupo multiplexado, a contagem é estimada pela fração do tempo em que o grupo esteve no processador.
+        valores[contador] = leitura[3 + grupo->posicao[contador]];
+        if(leitura[2] && leitura[2] < leitura[1])
+            valores[contador] = (unsigned long long) ((double) valores[contador] * leitura[1] / leitura[2]);
+    }
+
+    return TRUE;
+}
+
+void encerrarFaseContadores(const GrupoContadores *grupo, ContadoresHardware *fase, unsigned long long leitura[]){
+    unsigned long long atual[QUANTIDADE_CONTADORES];
+
+    if(!lerContadoresHardware(grupo, atual))
+        return;
+
+    // Uma estimativa de multiplexação pode ficar abaixo da anterior: a diferença negativa é descartada.
+    for(int contador = 0; contador < QUANTIDADE_CONTADORES; contador++){
+        if(atual[contador] > leitura[contador])
+            fase->valores[contador] += atual[contador] - leitura[contador];
+        leitura[contador] = atual[contador];
+    }
+}
+
+void fecharContadoresHardware(GrupoContadores *grupo){
+    for(int contador = 0; contador < QUANTIDADE_CONTADORES; contador++)
+        if(grupo->descritores[contador] >= 0){
+            close(grupo->descritores[contador]);
+            grupo->descritores[contador] = -1;
+        }
+}
+
+void exibirContadoresHardware(const GrupoContadores *grupo, const ContadoresHardware *fase, unsigned long long quantidade, const char *unidade){
+    static const char *nomes[QUANTIDADE_CONTADORES] = {"ciclos", "instruções", "desvios mal previstos", "falhas L1d", "falhas LLC"};
+
+    if(grupo->descritores[CONTADOR_INSTRUCOES] >= 0 && fase->valores[CONTADOR_CICLOS])
+        printf("\n\tIPC = %.2f", (double) fase->valores[CONTADOR_INSTRUCOES] / fase->valores[CONTADOR_CICLOS]);
+    else
+        printf("\n\tIPC = n/d");
+
+    printf("\n\tPor %s (%llu):", unidade, quantidade);
+    for(int contador = 0; contador < QUANTIDADE_CONTADORES; contador++){
+        if(grupo->descritores[contador] >= 0 && quantidade)
+            printf("%s %.2f %s", contador ? " |" : "", (double) fase->valores[contador] / quantidade, nomes[contador]);
+        else
+            printf("%s n/d %s", contador ? " |" : "", nomes[contador]);
+    }
+}
+
 pid_t criarProcesso(){
+    fflush(stdout); // Evita que o processo filho herde (e repita) o conteúdo do buffer de saída.
     pid_t pid = fork(); // Cria o processo filho.
-    if(pid < 0) exit(EXIT_FAILURE); // Verifica se ocorreu algum erro.
     return pid;
 }
 
+void encerrarProcessoFilho(int status){
+    fflush(stdout);
+    _exit(status);
+}
+
 unsigned short lerInstrucoesDoArquivo(Programa *programa, FILE *arquivo){
     char c;
     int contInstrucoes = 0, contChar = 0;
+    unsigned short linha = 1;
 
     while((c = getc(arquivo)) != EOF){
         // Verifica se o caracter é o inicio de um comentário e ignora todo o resto da linha
@@ -528,26 +3547,40 @@ unsigned short lerInstrucoesDoArquivo(Programa *programa, FILE *arquivo){
             while ((c = getc(arquivo)) != EOF && c != EOL); 
             if(contChar > 0){
                 programa->instrucoes[contInstrucoes][contChar] = '\0';
+                programa->linhas[contInstrucoes] = linha;
                 contChar = 0;
                 contInstrucoes++;
             }
+            linha++;
+            if(contInstrucoes > NUMERO_MAXIMO_DE_INSTRUCOES - 1) break; 
             continue;
         }
         // Encerra o loop caso encontre o final do arquivo.
         if(c == EOF) break;
-        // Checa se o caracter indica o final da linha
-        if(c != EOL && c != CARRIAGE_RETURN && contChar < TAMANHO_INSTRUCAO){
+        // Ignora os espaços no início da linha, para que linhas em branco não sejam lidas como instruções.
+        if(c == CHAR_VAZIO && contChar == 0) continue;
+        // Checa se o caracter indica o final da linha (o último caracter da instrução é reservado para o '\0').
+        if(c != EOL && c != CARRIAGE_RETURN && contChar < TAMANHO_INSTRUCAO - 1){
             programa->instrucoes[contInstrucoes][contChar] = c;
             contChar++;
         } else if(c == EOL && contChar > 0){
             programa->instrucoes[contInstrucoes][contChar] = '\0';
+            programa->linhas[contInstrucoes] = linha;
             contChar = 0;
             contInstrucoes++;
         }
 
+        if(c == EOL) linha++;
         if(contInstrucoes > NUMERO_MAXIMO_DE_INSTRUCOES - 1) break; 
     }
 
+    // Armazena a última instrução caso o arquivo não termine com uma quebra de linha.
+    if(contChar > 0 && contInstrucoes < NUMERO_MAXIMO_DE_INSTRUCOES){
+        programa->instrucoes[contInstrucoes][contChar] = '\0';
+        programa->linhas[contInstrucoes] = linha;
+        contInstrucoes++;
+    }
+
     return contInstrucoes++;
 } // lerInstrucoesDoArquivo()
 
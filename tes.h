@@ -2,12 +2,14 @@
 
 #include <sys/types.h> // Requerido por pid_t.
 #include <stdio.h>
+#include <pthread.h> // Requerido por pthread_mutex_t.
+#include <sched.h> // Requerido por cpu_set_t.
 
 // Tamanho máximo do nome de arquivo.
 #define TAMANHO_NOME_ARQUIVO 80
 
-// Tamanho máximo de uma instrução LPAS.
-#define TAMANHO_INSTRUCAO 10
+// Tamanho máximo de uma instrução LPAS (comporta as instruções de vetor com dois argumentos, como "VADD VETOR OUTRO").
+#define TAMANHO_INSTRUCAO 24
 
 // Número máximo de instruções do programa LPAS.
 #define NUMERO_MAXIMO_DE_INSTRUCOES 255
@@ -15,6 +17,15 @@
 // Número máximo de variáveis do programa.
 #define NUMERO_MAXIMO_DE_VARIAVEIS 50
 
+// Número máximo de elementos de um vetor (ARRAY).
+#define TAMANHO_MAXIMO_VETOR 1024
+
+// Número máximo de posições da memória de dados de um programa (variáveis simples e elementos dos vetores).
+#define TAMANHO_MAXIMO_MEMORIA 4096
+
+// Elementos processados por ut pelas instruções de vetor (a largura de um registrador AVX2 de inteiros de 32 bits).
+#define LARGURA_VETOR_UT 8
+
 // Número máximo de programas da máquina de execução.
 #define NUMERO_MAXIMO_DE_PROGRAMAS 4
 
@@ -29,6 +40,18 @@
 #define DIV 33
 #define HALT 40
 
+// Códigos das instruções de vetor LPAS (os códigos a partir de ARRAY são instruções de vetor).
+#define ARRAY 50
+#define VREAD 51
+#define VWRITE 52
+#define VADD 60
+#define VSUB 61
+#define VMUL 62
+#define VDIV 63
+#define VSUM 70
+#define VMIN 71
+#define VMAX 72
+
 // Representa uma instrução LPAS.
 typedef char Instrucao[TAMANHO_INSTRUCAO];
 
@@ -49,9 +72,87 @@ typedef struct  {
 	/* Memória de código para armazenar as instruções LPAS que compõem o programa.
 	   Cada instrução é armazenada em uma posição do vetor. */
 	Instrucao instrucoes[NUMERO_MAXIMO_DE_INSTRUCOES];
+
+	// Número da linha do arquivo em que cada instrução se encontra (utilizado nas mensagens de erro).
+	unsigned short linhas[NUMERO_MAXIMO_DE_INSTRUCOES];
 } Programa;
 
 
+// Tipo do argumento de uma instrução LPAS decodificada.
+typedef enum { ARGUMENTO_NENHUM, ARGUMENTO_IMEDIATO, ARGUMENTO_VARIAVEL, ARGUMENTO_VETOR 
+} TipoArgumento;
+
+// Representa uma instrução LPAS já decodificada: o código da instrução e o seu argumento resolvido.
+typedef struct {
+	// Código da instrução LPAS (READ, WRITE, ...).
+	unsigned char codigo;
+
+	// Indica se o argumento é um número (imediato), o endereço de uma variável ou os operandos de uma instrução de vetor.
+	unsigned char tipoArgumento;
+
+	// Valor numérico do argumento imediato, endereço (índice) da variável na memória de dados ou índice dos operandos de vetor.
+	int valor;
+} InstrucaoDecodificada;
+
+// Representa uma variável do programa: uma variável simples ou um vetor declarado com ARRAY.
+typedef struct {
+	// Identificador (nome) da variável.
+	NomeVariavel nome;
+
+	// Endereço da variável (do primeiro elemento, no caso de um vetor) na memória de dados.
+	int endereco;
+
+	// Quantidade de elementos do vetor, ou 0 para uma variável simples.
+	int tamanho;
+} SimboloVariavel;
+
+// Representa os operandos de uma instrução de vetor decodificada, que não cabem na InstrucaoDecodificada.
+typedef struct {
+	// Endereço do primeiro elemento e quantidade de elementos do vetor da instrução (o destino, nas operações elemento a elemento).
+	int endereco, tamanho;
+
+	// Tipo do segundo operando das operações elemento a elemento: ARGUMENTO_IMEDIATO, ARGUMENTO_VARIAVEL (replicada em todos os elementos) ou ARGUMENTO_VETOR.
+	unsigned char tipoOrigem;
+
+	// Valor imediato ou endereço do segundo operando.
+	int origem;
+} OperandosVetor;
+
+/* Código nativo de um programa (--aot): executa, a partir de *pc, no máximo limite instruções e para antes de qualquer instrução que
+   precise do interpretador (READ, WRITE, HALT e DIV por 0). Atualiza o registrador e o pc e retorna a quantidade de instruções executadas. */
+typedef unsigned (*FuncaoNativa)(int *registrador, int *variaveis, unsigned char *pc, unsigned limite);
+
+// Representa um programa LPAS decodificado uma única vez, com as variáveis resolvidas para endereços fixos.
+typedef struct {
+	// Número de instruções decodificadas (incluindo o HALT final).
+	unsigned short numeroDeInstrucoes;
+
+	// Quantidade de posições da memória de dados: uma por variável simples e uma por elemento de vetor.
+	int quantidadeVariaveis;
+
+	// Quantidade de valores lidos e escritos pelo programa: um por READ e WRITE e um por elemento de VREAD e VWRITE.
+	int quantidadeLeituras, quantidadeEscritas;
+
+	// Quantidade de instruções de vetor do programa.
+	unsigned short quantidadeInstrucoesVetor;
+
+	// Variáveis e vetores do programa, na ordem em que foram criados.
+	int quantidadeSimbolos;
+	SimboloVariavel simbolos[NUMERO_MAXIMO_DE_VARIAVEIS];
+
+	// Instruções decodificadas.
+	InstrucaoDecodificada instrucoes[NUMERO_MAXIMO_DE_INSTRUCOES];
+
+	// Operandos das instruções de vetor, indexados pelo pc da instrução.
+	OperandosVetor operandosVetor[NUMERO_MAXIMO_DE_INSTRUCOES];
+
+	// Hash do conteúdo (instruções decodificadas): identifica programas idênticos, mesmo com nomes ou comentários diferentes.
+	unsigned long long hash;
+
+	// Código nativo compilado (--aot), ou NULL para executar pelo interpretador.
+	FuncaoNativa nativo;
+} ProgramaDecodificado;
+
 /* Códigos resultantes da excução do programa LPAS. Os códigos válidos são:
  
 	 0 = execução bem sucedida; 
@@ -59,14 +160,16 @@ typedef struct  {
 	 2 = argumento de instrução LPAS inválido;
 	 3 = argumento de instrução LPAS ausente;
 	 4 = duas ou mais instruções LPAS na mesma linha de código;
-	 5 = símbolo inválido.
+	 5 = símbolo inválido;
+	 6 = limite da tarefa (tempo de CPU, tempo de relógio ou variáveis) excedido.
 */
 typedef enum { EXECUCAO_BEM_SUCEDIDA, 
 			   INSTRUCAO_LPAS_INVALIDA, 
 			   ARGUMENTO_INSTRUCAO_LPAS_INVALIDO, 
                ARGUMENTO_INSTRUCAO_LPAS_AUSENTE, 
 			   MUITAS_INSTRUCOES, 
-			   SIMBOLO_INVALIDO 
+			   SIMBOLO_INVALIDO,
+			   LIMITE_EXCEDIDO 
 } Erro;
 
 // Representa os dados sobre um erro de execução do programa.
@@ -77,49 +180,166 @@ typedef struct {
 	Erro erro;
 } ErroExecucao;			   
 
+// Representa uma unidade de tempo (ut), renomeada para dar mais sentido às variáveis da Struct RoudRobin.
+// Tem 32 bits para comportar latências de E/S longas (--latencia-es).
+typedef unsigned int UnidadeTempo;
+
 //  Indica o estado atual da tarefa. 
 typedef enum { NOVA, PRONTA, EXECUTANDO, SUSPENSA, TERMINADA 
 } EstadoTarefa;
 
+// Maior quantidade de valores lidos (READ) e escritos (WRITE) de um programa cujo resultado pode ser memoizado (--memo).
+#define MAXIMO_ENTRADAS_MEMO 16
+#define MAXIMO_ESCRITAS_MEMO 16
+
+/* Resultado de uma execução completa (até o HALT) de um programa com um vetor de entradas. Como o LPAS não tem desvios, o resultado
+   depende somente do programa e das entradas: a mesma execução sempre escreve os mesmos valores com o mesmo tempo de CPU e de E/S. */
+typedef struct {
+	// Hash do programa (ProgramaDecodificado.hash); 0 indica uma posição vazia do cache.
+	unsigned long long hashPrograma;
+
+	// Quantidade de entradas e de escritas (antes dos vetores, para que a consulta compare a chave lendo o mínimo de linhas de cache).
+	unsigned short quantidadeEntradas, quantidadeEscritas;
+
+	// Tempo de CPU e de E/S da execução.
+	unsigned short tempoCPU;
+	UnidadeTempo tempoES;
+
+	// Valores consumidos pelos READs, em ordem.
+	int entradas[MAXIMO_ENTRADAS_MEMO];
+
+	// Valores escritos pelos WRITEs, em ordem.
+	int escritas[MAXIMO_ESCRITAS_MEMO];
+} ResultadoMemoizado;
+
+/* Imagem de código de um programa: o texto, o programa decodificado e o código nativo, imutáveis depois da carga. As tarefas de programas
+   com o mesmo conteúdo compartilham uma única imagem, e cada tarefa guarda somente o seu contexto (pc, registrador e memória de dados). */
+typedef struct ImagemPrograma {
+	// Programa lido do arquivo (o nome é o do primeiro programa carregado com este conteúdo).
+	Programa programa;
+
+	// Programa verificado e decodificado na carga, executado pelo interpretador.
+	ProgramaDecodificado codigo;
+
+	// Hash do texto do programa (instruções e números das linhas), que identifica a imagem no índice.
+	unsigned long long hash;
+
+	// Quantidade de tarefas que referenciam a imagem; a imagem é liberada com a última referência.
+	int referencias;
+
+	// Próxima imagem do mesmo balde do índice.
+	struct ImagemPrograma *proxima;
+} ImagemPrograma;
+
+// Quantidade de baldes do índice de imagens.
+#define BALDES_IMAGENS 256
+
+// Índice das imagens carregadas, pelo hash do texto do programa.
+typedef struct {
+	// Trava que protege o índice e as contagens de referências (as threads de carga consultam o índice em paralelo).
+	pthread_mutex_t trava;
+
+	// Listas de imagens de cada balde.
+	ImagemPrograma *baldes[BALDES_IMAGENS];
+
+	// Quantidade de imagens (programas distintos) carregadas.
+	int quantidadeImagens;
+} IndiceImagens;
+
 // Como a tarefa (processo) é um programa em execução, esta estrutura relaciona a identificação de cada tarefa com o programa a ser executado por ela.
 typedef struct {
 	// Identificador da tarefa.
 	unsigned identificador;
 
-	// Programa a ser executado pela tarefa.
-	Programa programa;
+	// Nome do programa executado pela tarefa.
+	NomePrograma nome;
+
+	// Imagem de código (compartilhada) do programa a ser executado pela tarefa.
+	ImagemPrograma *imagem;
+
+	/* Valores consumidos pelas instruções READ, enviados pelo cliente junto com o programa (--servidor), em um buffer do trabalho.
+	   Com NULL os valores são digitados durante a execução. */
+	int *entradas;
+
+	// Quantidade de valores enviados e índice do próximo valor a ser lido.
+	unsigned short quantidadeEntradas, proximaEntrada;
+
+	/* Instante (ut, no relógio do processo tes) a partir do qual a tarefa pode ser admitida, informado como nome@ut.
+	   Com 0 a tarefa é admitida assim que possível; as tarefas disponíveis continuam sendo admitidas uma por ut. */
+	UnidadeTempo chegada;
+
+	/* Memoização (--memo): com memoizada, resultado foi encontrado no cache antes da execução e a tarefa é retirada sem interpretar o
+	   programa; caso contrário, resultado acumula as escritas da execução para ser guardado no cache ao seu término. */
+	ResultadoMemoizado resultado;
+	unsigned char memoizada;
 } Tarefa;
 
-// Representa o descritor da tarefa, conhecido como bloco de controle da tarefa (TCB - Task Control Block).
-typedef struct {
-	// Identificação da tarefa deste bloco de controle da tarefa.
-	Tarefa tarefa;
+// Tamanho de uma linha de cache, utilizado para alinhar o descritor da tarefa.
+#define TAMANHO_LINHA_CACHE 64
 
-	// Indica o estado atual da tarefa. O estado da tarefa deve ser atualizado segundo o seu ciclo de vida durante sua execução. 
-	EstadoTarefa estado;
+/* Representa o descritor da tarefa, conhecido como bloco de controle da tarefa (TCB - Task Control Block).
+   O descritor contém apenas os campos acessados a cada ut pelo escalonador e pelo interpretador, agrupados em uma
+   única linha de cache. Os dados frios (nome, texto do programa, números de linha) ficam na Tarefa referenciada,
+   e a memória de dados é alocada com o número exato de variáveis do programa. */
+typedef struct __attribute__((aligned(TAMANHO_LINHA_CACHE))) {
+	// Indica o estado atual da tarefa (EstadoTarefa). O estado da tarefa deve ser atualizado segundo o seu ciclo de vida durante sua execução. 
+	unsigned char estado;
 
 	// O contador de programa (PC - Program Counter) indica a próxima instrução do programa a ser executada.
 	unsigned char pc;
 
+	// Indica se a tarefa foi migrada para outro processo tes (não deve ser exibida no relatório deste processo).
+	unsigned char migrada;
+
+	// Indica se a tarefa foi abortada pelo watchdog por exceder um dos seus limites (--limite-cpu, --limite-tempo, --limite-variaveis).
+	unsigned char abortada;
+
+	// Quantidade de posições da memória de dados (resolvidas na carga do programa).
+	unsigned short quantidadeVariaveis;
+
+	// Ut restantes da instrução de vetor em execução: a instrução já foi executada, mas o seu custo ocupa a CPU por mais ut.
+	unsigned short ciclosPendentes;
+
 	// Indica o tempo total de uso do processador que a tarefa precisa para executar suas instruções. 
-	unsigned char tempoCPU;
+	unsigned short tempoCPU;
 
 	// Indica o tempo total das operações de E/S executadas pela tarefa, nesta implementação, o tempo total de E/S apenas das instruções READ. 
-	unsigned char tempoES;
+	UnidadeTempo tempoES;
 
 	// Salva o valor armazenado no registrador da máquina execução..
 	int registrador;
 
-	// Quantidade de variáveis.
-	int quantidadeVariaveis;
+	// Instante (ut) em que termina a E/S de uma tarefa SUSPENSA (E/S bloqueante, --latencia-es).
+	UnidadeTempo fimES;
 
-	// Identificador (nome) das variáveis
-	NomeVariavel nomesVariaveis[NUMERO_MAXIMO_DE_VARIAVEIS];
+	// Prazo (relógio monotônico, em ns) para o término da tarefa, ou 0 sem limite de tempo de relógio.
+	long long prazoNs;
 
-	// Memória de dados que armazena as variáveis do programa LPAS que está em execução na ME.
-	int variaveis[NUMERO_MAXIMO_DE_VARIAVEIS];
+	// Memória de dados (quantidadeVariaveis posições) que armazena as variáveis do programa LPAS, indexada pelo endereço da variável.
+	int *variaveis;
+
+	// Memória de código: instruções decodificadas do programa.
+	const InstrucaoDecodificada *instrucoes;
+
+	// Identificação da tarefa deste bloco de controle da tarefa (dados frios).
+	Tarefa *tarefa;
 } DescritorTarefa;
 
+// Representa a origem dos valores lidos (READ) e o destino dos valores escritos (WRITE) fora do modo interativo.
+typedef struct {
+	// Valores consumidos pelas instruções READ, em ordem, ou NULL para ler do teclado.
+	const int *entradas;
+
+	// Quantidade de valores disponíveis e índice do próximo valor a ser lido.
+	int quantidadeEntradas, proximaEntrada;
+
+	// Arquivo que recebe as escritas (WRITE), ou NULL para a saída padrão.
+	FILE *saida;
+
+	// Número da linha de entrada que está sendo executada (0 quando não se aplica).
+	unsigned long linha;
+} EntradaSaidaLote;
+
 // Representa a estrutura da máquina de execução LPAS.
 typedef struct  {
 	// Número de programas LPAS carregados na memória da Máquina de Execução.
@@ -134,21 +354,122 @@ typedef struct  {
 	// Registrador da máquina de execução LPAS.
 	int registrador;
 
-	// Quantidade de variáveis.
-	int quantidadeVariaveis;
-
-	// Identificador (nome) das variáveis
-	NomeVariavel nomesVariaveis[NUMERO_MAXIMO_DE_VARIAVEIS];
-
-	// Memória de dados que armazena as variáveis do programa LPAS que está em execução na ME.
-	int variaveis[NUMERO_MAXIMO_DE_VARIAVEIS];
+	// Memória de dados da tarefa em execução. A troca de contexto apenas troca o ponteiro, sem copiar as variáveis.
+	int *variaveis;
 
 	// Identifica a instrução, o número da linha e o nome do programa onde o erro de execução ocorreu.
 	ErroExecucao erroExecucao;
+
+	// Entradas e saída das instruções READ e WRITE nos modos não interativos.
+	EntradaSaidaLote lote;
+
+	// Latência (ut) da E/S bloqueante: o READ suspende a tarefa por latenciaES ut (0 = o READ não bloqueia).
+	UnidadeTempo latenciaES;
 } MaquinaExecucao;
 
-// Representa uma unidade de tempo (ut), renomeada para dar mais sentido às variáveis da Struct RoudRobin.
-typedef unsigned short int UnidadeTempo;
+// Tipos de eventos registrados pelo escalonador.
+typedef enum { EVENTO_ESTADO, EVENTO_PREEMPCAO, EVENTO_ERRO, EVENTO_MIGRACAO 
+} TipoEvento;
+
+// Representa um evento do escalonador: uma transição de estado, uma preempção, um erro ou uma migração de tarefa.
+typedef struct {
+	// Tempo de relógio monotônico (ns) em que o evento ocorreu.
+	long long tempoNs;
+
+	// Instante (ut) a partir do qual o novo estado vale.
+	UnidadeTempo ut;
+
+	// Índice da tarefa no descritor.
+	unsigned char tarefa;
+
+	// Tipo do evento (TipoEvento).
+	unsigned char tipo;
+
+	// Estados (EstadoTarefa) anterior e novo da tarefa.
+	unsigned char estadoAnterior, estadoNovo;
+
+	// Código do erro (EVENTO_ERRO).
+	unsigned char erro;
+} EventoEscalonador;
+
+// Capacidade (potência de 2) do buffer circular de eventos.
+#define CAPACIDADE_REGISTRO_EVENTOS 65536
+
+/* Buffer circular, pré-alocado, com os eventos do escalonador. Quando cheio, os eventos mais antigos são sobrescritos.
+   Com o registro desabilitado o vetor de eventos é NULL e registrarEvento retorna imediatamente. */
+typedef struct {
+	EventoEscalonador *eventos;
+
+	// Quantidade total de eventos registrados (o buffer guarda os CAPACIDADE_REGISTRO_EVENTOS últimos).
+	unsigned long long total;
+} RegistroEventos;
+
+// Medidas de tempo de relógio (ns, relógio monotônico) de uma tarefa, para os histogramas de latência.
+typedef struct {
+	// Instante da admissão (NOVA -> PRONTA) e instante em que a tarefa entrou pela última vez no estado PRONTA.
+	long long chegadaNs, prontaDesdeNs;
+
+	// Tempo total no estado PRONTA e tempo entre a admissão e o primeiro escalonamento.
+	long long esperaNs, respostaNs;
+
+	// Instante em que a tarefa terminou.
+	long long saidaNs;
+
+	// Tempo (ut) entre a admissão e o primeiro escalonamento.
+	UnidadeTempo respostaUt;
+
+	// Indica se a tarefa já foi escalonada alguma vez.
+	unsigned char despachada;
+} MedidasTarefa;
+
+// Cada potência de 2 é dividida em 2^BITS_SUBFAIXAS_HISTOGRAMA faixas: o erro relativo de um percentil é de no máximo 12,5%.
+#define BITS_SUBFAIXAS_HISTOGRAMA 3
+#define SUBFAIXAS_HISTOGRAMA (1 << BITS_SUBFAIXAS_HISTOGRAMA)
+
+// Quantidade de faixas necessária para valores de 64 bits.
+#define FAIXAS_HISTOGRAMA ((64 - BITS_SUBFAIXAS_HISTOGRAMA + 1) * SUBFAIXAS_HISTOGRAMA)
+
+// Histograma com faixas logarítmicas: valores até SUBFAIXAS_HISTOGRAMA são exatos, os demais caem em faixas proporcionais ao valor.
+typedef struct {
+	unsigned long long contagem[FAIXAS_HISTOGRAMA];
+
+	// Quantidade de valores registrados e maior valor registrado (exato).
+	unsigned long long total, maximo;
+} Histograma;
+
+// Latências medidas para cada tarefa.
+typedef enum { LATENCIA_EXECUCAO, LATENCIA_ESPERA, LATENCIA_RESPOSTA, QUANTIDADE_LATENCIAS 
+} TipoLatencia;
+
+// Histogramas de latência (tempo de execução, de espera e de resposta) em ut e em tempo de relógio (ns).
+typedef struct {
+	Histograma ut[QUANTIDADE_LATENCIAS];
+	Histograma ns[QUANTIDADE_LATENCIAS];
+} HistogramasLatencia;
+
+// Contadores de hardware (--contadores), na ordem em que são lidos do grupo.
+typedef enum { CONTADOR_CICLOS, CONTADOR_INSTRUCOES, CONTADOR_DESVIOS, CONTADOR_FALHAS_L1, CONTADOR_FALHAS_LLC, QUANTIDADE_CONTADORES
+} TipoContador;
+
+// Valores dos contadores de hardware acumulados em uma fase do processo tes (a execução de uma tarefa ou o escalonador).
+typedef struct {
+	unsigned long long valores[QUANTIDADE_CONTADORES];
+
+	// Instruções LPAS executadas pela tarefa durante as medições.
+	unsigned long long instrucoesLpas;
+} ContadoresHardware;
+
+/* Grupo de contadores de hardware do processo tes, aberto com perf_event_open: os ciclos lideram o grupo, e todos os contadores são
+   lidos juntos por uma única chamada read. Um contador que o processador não oferece fica com o descritor -1. */
+typedef struct {
+	int descritores[QUANTIDADE_CONTADORES];
+
+	// Posição de cada contador aberto na leitura do grupo.
+	int posicao[QUANTIDADE_CONTADORES];
+
+	// Quantidade de contadores abertos.
+	int quantidade;
+} GrupoContadores;
 
 // Representa os dados coletados pelo escalonador Round-Robin, para calcular os tempos médios após a execução dos programas.
 typedef struct {
@@ -158,13 +479,389 @@ typedef struct {
 	// Representa o contator de Preempção por tempo (Quantum)
 	UnidadeTempo contadorPreempcao;
 
-	// Matriz que representa o 'clock' (UT) em que cada programa entrou (NOVA -> PRONTA) e saiu (TERMINDADA) na fila do processador.
+	/* Matriz que representa o 'clock' (UT) em que cada programa entrou (NOVA -> PRONTA) e saiu (TERMINDADA) na fila do processador.
+	   Para uma tarefa com instante de chegada, a entrada é a chegada: o atraso até a admissão é tempo de espera. */
 	UnidadeTempo tempoEntradaESaidaFila[NUMERO_MAXIMO_DE_PROGRAMAS][2];
+
+	// UT em que cada tarefa foi admitida (NOVA -> PRONTA).
+	UnidadeTempo admissao[NUMERO_MAXIMO_DE_PROGRAMAS];
+
+	// Tempo de CPU e de E/S (ut) que cada tarefa recebida por migração já havia consumido em outros processos. Os relógios dos processos
+	// são independentes: a ocupação, a espera e a execução de uma tarefa migrada são calculadas somente com o tempo neste processo.
+	UnidadeTempo tempoAnterior[NUMERO_MAXIMO_DE_PROGRAMAS][2];
+
+	// Quantidade de tarefas enviadas para outros processos tes e recebidas de outros processos tes.
+	unsigned short migracoesEnviadas, migracoesRecebidas;
+
+	// Tempo de relógio (ns) gasto transferindo tarefas entre processos.
+	long long custoMigracaoNs;
+
+	// Tempo de relógio (ns) que o processo permaneceu ocioso aguardando uma tarefa migrada.
+	long long esperaMigracaoNs;
+
+	// Tempo (ut) em que a CPU ficou ociosa, com todas as tarefas suspensas aguardando E/S.
+	UnidadeTempo tempoOcioso;
+
+	// Quantidade de voltas do loop do escalonador (no avanço por eventos, uma volta pode avançar várias ut).
+	unsigned long iteracoes;
+
+	// Medidas de tempo de relógio de cada tarefa.
+	MedidasTarefa medidas[NUMERO_MAXIMO_DE_PROGRAMAS];
+
+	// Eventos do escalonador (--trace e --gantt).
+	RegistroEventos eventos;
+
+	// Contadores de hardware (--contadores): o grupo do processo (sem o líder, descritor -1, não há medição), os valores acumulados
+	// durante a execução de cada tarefa e os acumulados fora dela (escalonamento, admissões e migrações).
+	GrupoContadores grupoContadores;
+	ContadoresHardware contadores[NUMERO_MAXIMO_DE_PROGRAMAS];
+	ContadoresHardware contadoresEscalonador;
 } RoundRobin;
 
 // Número de programas que cada processo (fork) é capaz de executar
 #define MAX_PROGRAMAS_PROCESSO 2
 
+// Número máximo de processos tes criados por comando.
+#define NUMERO_MAXIMO_DE_PROCESSOS ((NUMERO_MAXIMO_DE_PROGRAMAS + MAX_PROGRAMAS_PROCESSO - 1) / MAX_PROGRAMAS_PROCESSO)
+
+// Indica que não há pedido de migração pendente para o processo.
+#define SEM_PEDIDO -1
+
+// Intervalo (us) entre as verificações do coordenador e dos processos ociosos.
+#define INTERVALO_COORDENACAO_US 200
+
+// Representa uma tarefa em trânsito entre dois processos tes.
+typedef struct {
+	// Indica se a caixa contém uma tarefa ainda não recebida pelo processo destino.
+	int ocupada;
+
+	// Contexto salvo da tarefa migrada. O ponteiro para a Tarefa é válido nos dois processos, pois o vetor de tarefas foi criado antes do fork.
+	DescritorTarefa descritor;
+
+	// Cópia da memória de dados da tarefa migrada (o descritor aponta para a memória do processo de origem).
+	int variaveis[TAMANHO_MAXIMO_MEMORIA];
+
+	// Medidas de tempo de relógio da tarefa (o relógio monotônico é o mesmo nos dois processos).
+	MedidasTarefa medidas;
+
+	// Contadores de hardware acumulados pela tarefa no processo de origem.
+	ContadoresHardware contadores;
+} CaixaMigracao;
+
+/* Quadro compartilhado (memória mapeada entre os processos) utilizado pelo coordenador de migração.
+   Cada processo tes publica sua carga e o coordenador (processo pai) pede aos processos ocupados
+   que transfiram uma tarefa PRONTA para os processos ociosos. */
+typedef struct {
+	// Trava compartilhada entre processos que protege todos os campos abaixo.
+	pthread_mutex_t trava;
+
+	// Número de processos tes participantes.
+	int numeroDeProcessos;
+
+	// Quantidade de tarefas PRONTAS de cada processo (candidatas à migração).
+	int prontas[NUMERO_MAXIMO_DE_PROCESSOS];
+
+	// Indica se o processo terminou suas tarefas e aguarda uma tarefa migrada.
+	int ocioso[NUMERO_MAXIMO_DE_PROCESSOS];
+
+	// Indica ao processo ocioso que não haverá mais migrações e que ele pode encerrar.
+	int encerrar[NUMERO_MAXIMO_DE_PROCESSOS];
+
+	// Processo destino para o qual o processo deve enviar uma tarefa, ou SEM_PEDIDO.
+	int pedido[NUMERO_MAXIMO_DE_PROCESSOS];
+
+	// Caixa de entrada de cada processo.
+	CaixaMigracao caixa[NUMERO_MAXIMO_DE_PROCESSOS];
+} QuadroMigracao;
+
+// Quantidade de segmentos do cache de resultados, cada um com a sua trava.
+#define SEGMENTOS_CACHE_RESULTADOS 64
+
+/* Segmento do cache de resultados: a trava, compartilhada entre processos (e threads), protege as posições do segmento e as suas
+   estatísticas. Cada segmento ocupa a sua própria linha de cache, para que as threads do modo map não disputem uma única trava. */
+typedef struct __attribute__((aligned(TAMANHO_LINHA_CACHE))) {
+	pthread_mutex_t trava;
+
+	// Estatísticas acumuladas: consultas, acertos, resultados guardados e resultados que substituíram outro.
+	unsigned long long consultas, acertos, insercoes, substituicoes;
+} SegmentoCacheResultados;
+
+/* Cache de resultados (--memo), em memória compartilhada criada antes dos processos tes: é compartilhado pelos processos de todos os
+   comandos do prompt, pelos trabalhos do modo servidor e pelas threads do modo map. Cada resultado ocupa a posição indicada pelo hash do
+   programa e das entradas (mapeamento direto), e um resultado novo substitui o anterior da posição, o que limita o tamanho do cache. */
+typedef struct {
+	// Quantidade de posições do cache.
+	int capacidade;
+
+	// Segmentos do cache: a posição p pertence ao segmento p % SEGMENTOS_CACHE_RESULTADOS.
+	SegmentoCacheResultados segmentos[SEGMENTOS_CACHE_RESULTADOS];
+
+	// Posições do cache.
+	ResultadoMemoizado resultados[];
+} CacheResultados;
+
+// Número de instâncias processadas por bloco no modo de execução vetorial (SIMD).
+#define INSTANCIAS_POR_BLOCO 4096
+
+/* Representa um bloco de instâncias de um mesmo programa LPAS executadas em paralelo (uma instância por "lane").
+   A memória é organizada como estrutura de vetores (SoA): cada registrador, variável, entrada e saída é uma linha
+   contígua com INSTANCIAS_POR_BLOCO posições, para que as operações aritméticas usem instruções SIMD. */
+typedef struct {
+	// Número de instâncias válidas no bloco.
+	int quantidadeInstancias;
+
+	// Registrador de cada instância.
+	int *registradores;
+
+	// Memória de dados: variaveis[endereco * INSTANCIAS_POR_BLOCO + instancia].
+	int *variaveis;
+
+	// Valores lidos por cada READ: entradas[leitura * INSTANCIAS_POR_BLOCO + instancia].
+	int *entradas;
+
+	// Valores escritos por cada WRITE: saidas[escrita * INSTANCIAS_POR_BLOCO + instancia].
+	int *saidas;
+
+	// Quantidade de valores de entrada disponíveis para cada instância.
+	unsigned short *colunas;
+
+	// Código do erro de cada instância (mascara a instância a partir da instrução que falhou).
+	unsigned char *erros;
+
+	// Contador de programa em que o erro de cada instância ocorreu.
+	unsigned short *pcErro;
+} LoteInstancias;
+
+/* Kernel aritmético do modo vetorial: aplica ADD, SUB ou MUL sobre os registradores de todas as instâncias.
+   O operando é a linha de uma variável (operandos) ou, caso operandos seja NULL, o valor imediato (escalar). */
+typedef void (*KernelAritmetico)(int codigo, int *registradores, const int *operandos, int escalar, int quantidade);
+
+// Kernel de redução das instruções de vetor: calcula VSUM, VMIN ou VMAX dos valores (a soma tem o resultado módulo 2^32).
+typedef int (*KernelReducao)(int codigo, const int *valores, int quantidade);
+
+// Separadores das colunas de um arquivo de entradas (CSV).
+#define SEPARADORES_ENTRADAS ",; \t\r\n"
+
+// Quantidade máxima de valores de entrada de uma execução nos modos map e servidor (uma linha ou um programa do pedido).
+#define MAXIMO_ENTRADAS_EXECUCAO TAMANHO_MAXIMO_MEMORIA
+
+// Tamanho máximo de uma linha do arquivo de entradas (até 11 caracteres e um separador por valor).
+#define TAMANHO_LINHA_ENTRADAS (MAXIMO_ENTRADAS_EXECUCAO * 12)
+
+// Número de linhas de entrada distribuídas a cada thread por vez no modo map.
+#define LINHAS_POR_BLOCO_MAP 1024
+
+// Com --memo, um bloco do modo map cujas primeiras AMOSTRA_MEMO_MAP linhas não acertam o cache executa as demais sem consultá-lo.
+#define AMOSTRA_MEMO_MAP 128
+
+// Estado de um bloco de linhas do modo map.
+typedef enum { BLOCO_LIVRE, BLOCO_LIDO, BLOCO_EXECUTANDO, BLOCO_CONCLUIDO 
+} EstadoBloco;
+
+// Representa um bloco de linhas de entrada do modo map e as saídas produzidas por ele.
+typedef struct {
+	// Estado do bloco no ciclo leitura -> execução -> escrita.
+	EstadoBloco estado;
+
+	// Número (a partir de 1) da primeira linha do bloco e quantidade de linhas.
+	unsigned long primeiraLinha;
+	int quantidadeLinhas;
+
+	// Valores de cada linha: valores[linha * colunasPorLinha + coluna].
+	int *valores;
+
+	// Valores guardados por linha: os consumidos pelos READs do programa (as colunas excedentes são descartadas).
+	int colunasPorLinha;
+
+	// Quantidade de colunas de cada linha.
+	unsigned short colunas[LINHAS_POR_BLOCO_MAP];
+
+	// Texto produzido pelas instruções WRITE (e erros) das linhas do bloco.
+	char *saida;
+	size_t tamanhoSaida;
+} BlocoMap;
+
+// Representa a fila de blocos compartilhada entre a leitura, as threads de execução e a escrita do modo map.
+typedef struct {
+	pthread_mutex_t trava;
+	pthread_cond_t mudouEstado;
+
+	// Programa executado em todas as linhas.
+	Tarefa *tarefa;
+
+	// Arquivo de entradas.
+	FILE *arquivo;
+
+	// Blocos em circulação (vetor circular indexado pela sequência do bloco).
+	BlocoMap *blocos;
+	int quantidadeBlocos;
+
+	// Sequência do próximo bloco a ser executado e total de blocos lidos (válido quando fimLeitura for TRUE).
+	unsigned long proximoExecutar, totalBlocos;
+	int fimLeitura;
+} FilaMap;
+
+// Quantidade máxima de programas carregados à frente da execução (limita a memória ocupada pelas tarefas ainda não executadas).
+#define JANELA_CARREGAMENTO 256
+
+// Estado da carga de um programa pelas threads de carga.
+typedef enum { CARGA_PENDENTE, CARGA_CONCLUIDA, CARGA_INEXISTENTE, CARGA_INVALIDA 
+} EstadoCarga;
+
+/* Programas de um comando do prompt, carregados e verificados em paralelo por um conjunto de threads.
+   As threads carregam os programas na ordem do comando, enquanto o processo principal executa os já carregados. */
+typedef struct {
+	pthread_mutex_t trava;
+
+	// Sinaliza a conclusão da carga de um programa (para o consumidor) e o consumo de um programa (para as threads de carga).
+	pthread_cond_t carregado, consumido;
+
+	// Nomes dos programas (sem a extensão) e quantidade de programas.
+	NomePrograma *nomes;
+	int quantidade;
+
+	// Índice do próximo programa a ser carregado e quantidade de programas já consumidos pela execução.
+	int proximo, consumidos;
+
+	// Resultado da carga de cada programa: a tarefa (alocada pela thread de carga), o estado (EstadoCarga) e o erro de verificação.
+	Tarefa **tarefas;
+	unsigned char *estados;
+	ErroExecucao *erros;
+
+	pthread_t *threads;
+	long quantidadeThreads;
+} CarregadorProgramas;
+
+// Representa as opções informadas na linha de comando do programa tes.
+typedef struct {
+	// Executa os processos tes simultaneamente e migra tarefas PRONTAS de processos ocupados para processos ociosos.
+	int migracao;
+
+	// Programa executado no modo vetorial (--simd), ou NULL.
+	char *programaSimd;
+
+	// Programa executado no modo map (--map), ou NULL.
+	char *programaMap;
+
+	// Arquivo de entradas dos modos em lote (uma instância por linha).
+	char *arquivoEntradas;
+
+	// Arquivo de saída do modo map (--saida), ou NULL para a saída padrão.
+	char *arquivoSaida;
+
+	// Prefixo dos arquivos de eventos no formato Chrome trace (--trace), ou NULL. Cada processo grava <prefixo>.tes<N>.json.
+	char *prefixoTrace;
+
+	// Exibe o diagrama de Gantt (em ut) no relatório de cada processo.
+	int gantt;
+
+	// Latência (ut) da E/S bloqueante (--latencia-es), ou 0 para que o READ não suspenda a tarefa.
+	int latenciaES;
+
+	// Avança o relógio diretamente para o próximo evento (--eventos) em vez de 1 ut por volta do loop.
+	int eventos;
+
+	// Caminho do socket Unix do modo servidor (--servidor), ou NULL para o modo interativo.
+	char *caminhoServidor;
+
+	// Quantidade máxima de trabalhos executados simultaneamente no modo servidor (--concorrencia).
+	int concorrencia;
+
+	// Limites de cada tarefa (0 = sem limite): tempo de CPU (ut), tempo de relógio desde a admissão (ms) e quantidade de variáveis.
+	int limiteCPU, limiteTempoMs, limiteVariaveis;
+
+	// Fixa os processos tes em núcleos (--afinidade): cada processo em um núcleo, ou todos no conjunto (--afinidade-compartilhada).
+	int afinidade, afinidadeCompartilhada;
+
+	// Núcleos utilizados pela afinidade: primeiro um núcleo de cada núcleo físico, depois os demais (hyperthreads).
+	unsigned short ordemNucleos[CPU_SETSIZE];
+	int quantidadeNucleos;
+
+	// Diretório do cache de código nativo (--aot), ou NULL para executar somente pelo interpretador.
+	char *diretorioNativo;
+
+	// Quantidade de posições do cache de resultados (--memo), ou 0 sem memoização.
+	int capacidadeMemo;
+
+	// Mede os contadores de hardware de cada tarefa e do escalonador (--contadores).
+	int contadores;
+} Configuracao;
+
+// Opções da linha de comando.
+#define OPCAO_MIGRAR "migrar"
+#define OPCAO_SIMD "simd"
+#define OPCAO_MAP "map"
+#define OPCAO_SAIDA "saida"
+#define OPCAO_TRACE "trace"
+#define OPCAO_GANTT "gantt"
+#define OPCAO_LATENCIA_ES "latencia-es"
+#define OPCAO_EVENTOS "eventos"
+#define OPCAO_CONTADORES "contadores"
+
+#define OPCAO_LIMITE_CPU "limite-cpu"
+#define OPCAO_LIMITE_TEMPO "limite-tempo"
+#define OPCAO_LIMITE_VARIAVEIS "limite-variaveis"
+#define OPCAO_AFINIDADE "afinidade"
+#define OPCAO_AFINIDADE_COMPARTILHADA "afinidade-compartilhada"
+#define OPCAO_AOT "aot"
+#define OPCAO_MEMO "memo"
+#define OPCAO_SERVIDOR "servidor"
+#define OPCAO_CONCORRENCIA "concorrencia"
+
+// Maior latência de E/S aceita por --latencia-es (mantém o relógio de 32 bits longe do overflow).
+#define LATENCIA_ES_MAXIMA 1000000
+
+// Separa o nome do programa do instante da sua chegada (ex.: add@10) e maior instante de chegada aceito (igual à maior latência de E/S,
+// para que um salto do relógio ocioso sempre alcance o próximo evento).
+#define SEPARADOR_CHEGADA '@'
+#define CHEGADA_MAXIMA LATENCIA_ES_MAXIMA
+
+/* Compilação do código nativo (--aot): o programa é traduzido para C, compilado pelo compilador do sistema (variável CC, ou cc) como
+   biblioteca compartilhada e carregado com dlopen. O objeto é guardado no diretório do cache com o hash do programa como nome. */
+#define DIRETORIO_NATIVO_PADRAO ".tes-aot"
+#define COMPILADOR_PADRAO "cc"
+#define SIMBOLO_NATIVO "tes_executar"
+#define TAMANHO_CAMINHO_NATIVO 512
+
+// Versão do gerador de código, incluída no hash: um gerador novo não reutiliza os objetos gerados pelo anterior.
+#define VERSAO_CODIGO_NATIVO 2
+
+// Quantidade padrão de posições do cache de resultados (--memo).
+#define CAPACIDADE_MEMO_PADRAO 4096
+
+// O watchdog consulta o relógio quando a tarefa é escalonada e a cada INTERVALO_WATCHDOG instruções (potência de 2).
+#define INTERVALO_WATCHDOG 64
+
+/* Protocolo do modo servidor: o cliente envia um pedido em texto, uma linha por comando, e recebe as escritas (WRITE),
+   os erros e os relatórios dos processos tes. O servidor encerra a conexão ao final do trabalho.
+	PROGRAMA nome [valores...]    Executa nome.lpas (do diretório do servidor); os valores alimentam os READs, em ordem.
+	                              Como no prompt, nome@ut define o instante de chegada da tarefa.
+	FONTE nome [valores...]       Executa o código LPAS enviado nas linhas seguintes, até a linha FIM.
+	EXECUTAR                      Encerra o pedido (o fim da conexão tem o mesmo efeito). */
+#define COMANDO_PROGRAMA "PROGRAMA"
+#define COMANDO_FONTE "FONTE"
+#define COMANDO_FIM_FONTE "FIM"
+#define COMANDO_EXECUTAR "EXECUTAR"
+
+// Tamanho máximo de uma linha do pedido (comando, nome e até MAXIMO_ENTRADAS_EXECUCAO valores).
+#define TAMANHO_LINHA_PEDIDO (TAMANHO_NOME_ARQUIVO + TAMANHO_LINHA_ENTRADAS)
+
+// Número de ut exibidas por linha do diagrama de Gantt.
+#define COLUNAS_GANTT 100
+
+// Número máximo de colunas do diagrama de Gantt (10 linhas de COLUNAS_GANTT); execuções mais longas agrupam várias ut por coluna.
+#define LARGURA_MAXIMA_GANTT (10 * COLUNAS_GANTT)
+
+// Estado de uma tarefa no diagrama de Gantt antes do seu primeiro evento guardado (registro circular cheio).
+#define ESTADO_DESCONHECIDO -1
+
+// Irmãos de hyperthread de um núcleo lógico, usados para distribuir os processos entre os núcleos físicos.
+#define CAMINHO_TOPOLOGIA_NUCLEO "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list"
+#define TAMANHO_CAMINHO_TOPOLOGIA 96
+
+// Tamanho máximo de uma lista de núcleos (ex.: "0-3,8-11").
+#define TAMANHO_LISTA_NUCLEOS 256
+
 // Representa a string do prompt à ser exibido.
 #define PROMPT "tes > "
 
@@ -184,9 +881,19 @@ typedef struct {
 #define INST_MUL "MUL"
 #define INST_DIV "DIV"
 #define INST_HALT "HALT"
+#define INST_ARRAY "ARRAY"
+#define INST_VREAD "VREAD"
+#define INST_VWRITE "VWRITE"
+#define INST_VADD "VADD"
+#define INST_VSUB "VSUB"
+#define INST_VMUL "VMUL"
+#define INST_VDIV "VDIV"
+#define INST_VSUM "VSUM"
+#define INST_VMIN "VMIN"
+#define INST_VMAX "VMAX"
 
 // Número de instruções LPAS existentes.
-#define QUANTIDADE_INST_LPAS 9
+#define QUANTIDADE_INST_LPAS 19
 
 // Representa o modo de abertura apenas leitura para arquivos FILE.
 #define APENAS_LEITURA "r"
@@ -227,8 +934,28 @@ typedef struct {
 // Retorno execução do comando HALT
 #define RETURN_FIM 1
 
+// Retorno execução de um READ bloqueante: a tarefa deve ser suspensa até o fim da E/S.
+#define RETURN_ES 2
+
 // Mensagens
+#define ERRO_NOME_LONGO "O caminho %s excede o tamanho máximo de um nome de programa (%d caracteres, com a chegada) e foi ignorado!\n"
 #define ERRO_PROGRAMA_NAO_EXISTE "O programa %s não existe!\n"
+#define ERRO_OPCAO_INVALIDA "Uso: tes [--migrar] [--trace prefixo] [--gantt] [--latencia-es ut] [--eventos] [--contadores] [--limite-cpu ut] [--limite-tempo ms] [--limite-variaveis n] [--afinidade[=núcleos] [--afinidade-compartilhada]] [--aot[=diretório]] [--memo[=n]] | tes --servidor socket [--concorrencia n] [--contadores] [--aot[=diretório]] [--memo[=n]] | tes --simd programa entradas.csv | tes --map programa entradas.csv [--saida arquivo] [--aot[=diretório]] [--memo[=n]]\n"
+#define ERRO_ARQUIVO_NAO_EXISTE "O arquivo %s não existe!\n"
+#define ERRO_MEMORIA_INSUFICIENTE "Memória insuficiente!\n"
+#define ERRO_SOCKET "Não foi possível criar o socket %s!\n"
+#define ERRO_PEDIDO_INVALIDO "Pedido inválido: %s\n"
+#define ERRO_CRIAR_PROCESSO "Não foi possível criar o processo tes%d (%s): as suas tarefas não foram executadas!\n"
+#define ERRO_CRIAR_TRABALHO "Não foi possível criar o processo do trabalho (%s): tente novamente.\n"
+#define ERRO_CONTADORES "Contadores de hardware indisponíveis (%s): verifique /proc/sys/kernel/perf_event_paranoid. Executando sem --contadores.\n"
+#define ERRO_THREADS_MAP "Não foi possível criar as threads do modo map!\n"
+#define ERRO_LEITURAS_EXCEDIDAS "O programa %s lê %d valores, mas nos modos --map e --servidor uma execução recebe no máximo %d!\n"
+#define ERRO_MIGRACAO_LEITURA "O programa %s lê valores do teclado: o grupo é executado sem --migrar.\n"
+#define ERRO_DIRETORIO_NATIVO "O diretório %s não pertence ao usuário ou permite escrita a outros usuários: executando sem --aot.\n"
+#define ERRO_SIMD_VETORES "O programa %s possui instruções de vetor, que não são executadas pelo modo --simd!\n"
+#define TITULO_LATENCIAS_PROCESSOS "Latências de todos os processos"
+#define TITULO_LATENCIAS_SERVIDOR "Latências de todos os trabalhos do servidor"
+#define MSG_SERVIDOR "Servidor tes em %s (até %d trabalhos simultâneos)\n"
 #define MSG_BOASVINDAS "\n\tTask Execution and Scheduling [versão 3.0.1]\n\tVinicius J P Silva. Todos os direitos reservados.\n\n"
 
 // Valores boleanos.
@@ -241,6 +968,12 @@ typedef struct {
 // A linha de comando pode ler o nome de até 4 arquivos LPAS, mais os espaçoes em branco entre os mesmos.
 #define TAMANHO_LINHA_COMANDO (TAMANHO_NOME_ARQUIVO * NUMERO_MAXIMO_DE_PROGRAMAS + 3)
 
+/*
+	Lê as opções da linha de comando e as armazena na Configuracao.
+	Retorna: TRUE caso todas as opções sejam válidas ou FALSE caso não.
+*/
+int lerOpcoes(int argc, char *argv[], Configuracao *configuracao);
+
 /*
 	Função responsável por exibir o prompt, ler e executar os programas LPAS e finalizar o prompt quando o comando "exit" for inserido.
 	Retorna: EXIT_SUCCESS.
@@ -259,128 +992,544 @@ void exibirPrompt(const char *prompt);
 char * lerComando();
 
 /*
-	Obtém os nomes dos programas informados na linha de comando e os armazena em um vetor Tarefa.
-	Quantidade máxima de nomes lidos = NUMERO_MAXIMO_DE_PROGRAMAS
-	Retona: O número de nomes de programas obtidos.
+	Expande um argumento da linha de comando em nomes de programas (sem a extensão EXTENSAO_LPAS), acrescentados ao vetor *nomes:
+	> diretório: todos os arquivos EXTENSAO_LPAS do diretório, em ordem alfabética;
+	> padrão glob (com *, ? ou [): os arquivos EXTENSAO_LPAS que correspondem ao padrão, em ordem alfabética;
+	> caso contrário (ou caso o padrão não corresponda a nenhum arquivo), o próprio argumento.
+	O vetor é realocado conforme necessário (*capacidade posições). Os caminhos que não cabem em um nome de programa são informados e ignorados.
+	Retorna: a nova quantidade de nomes, ou NAO_ENCONTRADO caso não haja memória.
 */
-unsigned short obterNomesProgramas(const char *linhaDeComando, Tarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS]);
+int expandirProgramas(const char *argumento, NomePrograma **nomes, int quantidade, int *capacidade);
 
 /*
-	Percorre o vetor de tarefas, tenta abrir o arquivo correspondente, armazena as instruções LPAS seus respectivos Programas.
-	Retorna: O número de programas que efetivamente podem ser executados (existe um arquivo de extensão EXTENSAO_LPAS)
+	Carrega e verifica os programas em paralelo (CarregadorProgramas) e os executa em grupos de NUMERO_MAXIMO_DE_PROGRAMAS
+	(executarProgramas), na ordem informada, assim que cada grupo estiver carregado.
+	Os erros de carga (programa inexistente ou inválido) são coletados e exibidos ao final.
 */
-unsigned short obterInstrucoesProgramas(Tarefa tarefas[], unsigned short quantidadeProgramas);
+void executarProgramasCarregados(NomePrograma nomes[], int quantidade);
 
 /*
-	Cria um ou dois processos para executar os programas LPAS.
-	- 1 ou 2 programas LPAS = 1 processo.
-	- 2 ou 3 programas LPAS = 2 processos.
+	Inicia as threads de carga dos programas.
+	Retorna: TRUE ou FALSE caso não haja memória ou não seja possível criar as threads.
 */
-void executarProgramas(Tarefa tarefas[], unsigned short quantidadeProgramas);
+int iniciarCarregador(CarregadorProgramas *carregador, NomePrograma nomes[], int quantidade);
 
 /*
-	Função responsável por executar as tarefas (progamas LPAS) e escalonar as mesmas.
+	Thread de carga: carrega e verifica os programas, na ordem, até JANELA_CARREGAMENTO programas à frente do consumo.
 */
-void executarEscalonarTarefas(Tarefa tarefas[MAX_PROGRAMAS_PROCESSO], unsigned short quantidadeProgramas, unsigned short tes);
+void * carregarProgramas(void *argumento);
 
 /*
-	Busca, decodifica e executa a proxima instrução do programa desejado.
-	Retorna: EXECUCAO_BEM_SUCEDIDA caso a interpretação seja concluída com sucesso,
-		ou o devido código de ERRO, caso não.
+	Carrega o arquivo nome + EXTENSAO_LPAS e verifica o programa. Pode ser executada por várias threads ao mesmo tempo.
+	Retorna: CARGA_CONCLUIDA, CARGA_INEXISTENTE ou CARGA_INVALIDA (com os dados do erro em *erro).
 */
-int interpretador(unsigned short indiceTarefa, MaquinaExecucao *maquina);
+EstadoCarga carregarPrograma(const char *nome, Tarefa *tarefa, ErroExecucao *erro);
 
 /*
-	Executa ums instrução LPAS correspondente ao código da instrução informado (tipoInstrucao).
-	Retorna:
-		RETURN_ERRO: Caso ocorra algum erro durante a execução.
-		RETURN_OK: Caso a execução seja bem sucedida.
-		RETURN_FIM: Caso a instrução informada seja HALT.
+	Aguarda a carga do programa indicado e o marca como consumido.
+	Retorna: a tarefa carregada (a ser liberada pelo chamador) ou NULL caso a carga tenha falhado.
 */
-int executarInstrucao(int tipoInstrucao, Instrucao dado, unsigned short indiceTarefa, MaquinaExecucao *maquina);
+Tarefa * aguardarPrograma(CarregadorProgramas *carregador, int index);
 
 /*
-	Exibe o prompt “READ: ”, lê um valor inteiro do teclado e armazena na variável correspondente.
-	Retorna:
-		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
-		Código de erro: Caso ocorra algum erro.
+	Aguarda o término das threads de carga, exibe os erros coletados e libera o carregador.
 */
-int lpasRead(Instrucao dado, unsigned short indiceTarefa, MaquinaExecucao *maquina);
+void encerrarCarregador(CarregadorProgramas *carregador);
 
 /*
-	Escreve na tela a mensagem “WRITE: ”, seguida do valor armazenado na variável informada ou o dígito numérico que acompanha a instrução.
-	Retorna:
-		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
-		Código de erro: Caso ocorra algum erro.
+	Carrega (carregarPrograma) o programa de cada tarefa, cujo nome já está na tarefa, exibindo os erros encontrados.
+	Os programas inexistentes ou inválidos são retirados do vetor de tarefas antes de ocupar um processo.
+	Retorna: O número de programas válidos.
 */
-int lpasWrite(Instrucao dado, unsigned short indiceTarefa, MaquinaExecucao *maquina);
+unsigned short carregarTarefas(Tarefa tarefas[], unsigned short quantidadeProgramas);
 
 /*
-	Carrega para o registrador da máquina o valor de uma variável ou o dígito numérico que acompanha a instrução.
-	Retorna:
-		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
-		Código de erro: Caso ocorra algum erro.
+	Obtém a imagem do programa lido: procura no índice uma imagem com o mesmo texto e, caso não exista, verifica (decodificarPrograma),
+	compila (--aot) e publica uma imagem nova. A verificação e a compilação são feitas fora da trava do índice.
+	Retorna: a imagem, com uma referência a mais, ou NULL caso o programa seja inválido (os dados do erro são armazenados em *erro).
 */
-int lpasLoad(Instrucao dado, MaquinaExecucao *maquina);
+ImagemPrograma * obterImagemPrograma(Programa *programa, ErroExecucao *erro);
 
 /*
-	Adiciona o valor do registrador ao valor de uma variável ou número e armazena o resultado no registrador.
-	Retorna:
-		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
-		Código de erro: Caso ocorra algum erro.
+	Procura no índice a imagem com o texto do programa. Deve ser chamada com a trava do índice obtida.
+	Retorna: a imagem ou NULL caso o texto ainda não tenha sido carregado.
 */
-int lpasAdd(Instrucao dado, MaquinaExecucao *maquina);
+ImagemPrograma * procurarImagemPrograma(Programa *programa, unsigned long long hash);
 
 /*
-	Subtrai o valor do registrador do valor de uma variável ou número e armazena o resultado no registrador.
-	Retorna:
-		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
-		Código de erro: Caso ocorra algum erro.
+	Libera uma referência da imagem; a imagem é retirada do índice e liberada com a última referência.
 */
-int lpasSub(Instrucao dado, MaquinaExecucao *maquina);
+void liberarImagemPrograma(ImagemPrograma *imagem);
 
 /*
-	Multiplica o valor do registrador com valor de uma variável ou número e armazena o resultado no registrador.
-	Retorna:
-		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
-		Código de erro: Caso ocorra algum erro.
+	Calcula o hash (FNV-1a de 64 bits) do texto do programa: as instruções e os números das suas linhas.
+	Retorna: o hash do texto.
 */
-int lpasMul(Instrucao dado, MaquinaExecucao *maquina);
+unsigned long long calcularHashFonte(Programa *programa);
 
 /*
-	Divide o valor do registrador pelo valor de uma variável ou número e armazena o resultado no registrador.
-	Retorna:
-		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
-		Código de erro: Caso ocorra algum erro.
+	Compara o texto de dois programas (as instruções e os números das linhas).
+	Retorna: TRUE caso sejam iguais ou FALSE caso não.
 */
-int lpasDiv(Instrucao dado, MaquinaExecucao *maquina);
+int compararFontes(Programa *programa, Programa *outro);
 
 /*
-	Armazena o valor do registrador em uma variável.
-	Retorna:
-		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
-		Código de erro: Caso ocorra algum erro.
+	Verifica se alguma tarefa lê valores do teclado (READ sem entradas enviadas), informando a primeira encontrada.
+	Retorna: TRUE caso alguma tarefa leia do teclado ou FALSE caso não.
 */
-int lpasStore(Instrucao dado, MaquinaExecucao *maquina);
+int possuiLeituraInterativa(Tarefa tarefas[], unsigned short quantidadeProgramas);
 
 /*
-	Busca o endereco (indice) de uma variável, utilizando o seu nome.
-	Retorna o endereco (indice) da variável ou NAO_ENCONTRADO, caso não encontre a mesma.
+	Cria um ou dois processos para executar os programas LPAS.
+	- 1 ou 2 programas LPAS = 1 processo.
+	- 2 ou 3 programas LPAS = 2 processos.
+	Com a opção --migrar os processos são executados simultaneamente e o processo pai coordena a migração de tarefas.
+	Os histogramas de latência de cada processo são acumulados em latenciasGlobais (memória compartilhada), quando informado.
+*/
+void executarProgramas(Tarefa tarefas[], unsigned short quantidadeProgramas, HistogramasLatencia *latenciasGlobais);
+
+/*
+	Função responsável por executar as tarefas (progamas LPAS) e escalonar as mesmas.
+	As tarefas são referenciadas pelos descritores e devem permanecer válidas durante toda a execução.
+	O quadro de migração é NULL quando a migração de tarefas está desabilitada.
+*/
+void executarEscalonarTarefas(Tarefa tarefas[], unsigned short quantidadeProgramas, unsigned short tes, QuadroMigracao *quadro, HistogramasLatencia *latenciasGlobais);
+
+/*
+	Aloca o quadro de migração em memória compartilhada (herdada pelos processos filhos) e inicializa a trava.
+	Retorna: o quadro alocado ou NULL caso não seja possível alocá-lo.
+*/
+QuadroMigracao * criarQuadroMigracao(int numeroDeProcessos);
+
+/*
+	Libera o quadro de migração alocado por criarQuadroMigracao.
+*/
+void destruirQuadroMigracao(QuadroMigracao *quadro);
+
+/*
+	Coordenador de migração executado pelo processo pai enquanto houver processos filhos em execução.
+	> Pede aos processos com tarefas PRONTAS que enviem uma tarefa aos processos ociosos.
+	> Libera os processos ociosos quando não houver mais tarefas a migrar.
+*/
+void coordenarMigracoes(QuadroMigracao *quadro, pid_t processos[], int numeroDeProcessos);
+
+/*
+	Publica a carga do processo e envia uma tarefa PRONTA para o processo destino pedido pelo coordenador ou, sem pedido, para um
+	processo ocioso. A tarefa em execução (indexFila) nunca é migrada.
+*/
+void atenderPedidoMigracao(QuadroMigracao *quadro, int processo, MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short indexFila);
+
+/*
+	Procura um processo ocioso, com a caixa de entrada livre e sem tarefa pedida a caminho. Deve ser chamada com a trava do quadro.
+	Retorna: o índice do processo ou SEM_PEDIDO.
+*/
+int procurarProcessoOcioso(QuadroMigracao *quadro, int processo);
+
+/*
+	Sinaliza que o processo está ocioso e aguarda uma tarefa migrada ou a liberação do coordenador.
+	Um processo sem posição livre para outra tarefa (NUMERO_MAXIMO_DE_PROGRAMAS) não recebe migrações.
+	Retorna: TRUE caso uma tarefa tenha sido recebida ou FALSE caso o processo possa encerrar.
+*/
+int aguardarMigracao(QuadroMigracao *quadro, int processo, MaquinaExecucao *maquina, RoundRobin *roudRobin);
+
+/*
+	Retorna: o tempo de relógio monotônico atual em nanossegundos.
+*/
+long long obterTempoNs();
+
+/*
+	Verificador estático: decodifica o programa LPAS uma única vez, identificando as instruções, convertendo os
+	argumentos numéricos e associando cada variável a um endereço fixo da memória de dados. Rejeita instruções
+	inválidas, argumentos ausentes ou inválidos, variáveis lidas antes de definidas e programas sem HALT.
+	Retorna: EXECUCAO_BEM_SUCEDIDA ou o código do erro, cujos dados (com a linha do arquivo) são armazenados em *erro.
+*/
+int decodificarPrograma(Programa *programa, ProgramaDecodificado *decodificado, ErroExecucao *erro);
+
+/*
+	Decodifica uma instrução de vetor: ARRAY (nome e tamanho), VADD, VSUB, VMUL e VDIV (vetor de destino e um vetor do mesmo tamanho,
+	uma variável simples ou um número) e VREAD, VWRITE, VSUM, VMIN e VMAX (um vetor). Os operandos são armazenados em operandosVetor[pc].
+	Retorna: EXECUCAO_BEM_SUCEDIDA ou o código do erro.
+*/
+int decodificarInstrucaoVetor(int tipoInstrucao, char *argumento, unsigned short pc, ProgramaDecodificado *decodificado);
+
+/*
+	Procura a variável (simples ou vetor) pelo nome.
+	Retorna: o índice da variável em decodificado->simbolos ou NAO_ENCONTRADO.
+*/
+int procurarVariavel(ProgramaDecodificado *decodificado, const char *nome);
+
+/*
+	Cria uma variável simples (tamanho 0) ou um vetor, reservando as suas posições na memória de dados.
+	Retorna: o índice da variável em decodificado->simbolos ou NAO_ENCONTRADO, caso exceda NUMERO_MAXIMO_DE_VARIAVEIS ou TAMANHO_MAXIMO_MEMORIA.
+*/
+int criarVariavel(ProgramaDecodificado *decodificado, const char *nome, int tamanho);
+
+/*
+	Calcula o custo (ut) de uma instrução de vetor: 1 ut a cada LARGURA_VETOR_UT elementos, independentemente do kernel utilizado.
+	Retorna: o custo da instrução.
+*/
+unsigned short calcularCustoVetor(int tamanho);
+
+/*
+	Calcula o hash (FNV-1a de 64 bits) das instruções decodificadas do programa e da versão do gerador de código nativo.
+	Retorna: o hash do programa.
+*/
+unsigned long long calcularHashPrograma(ProgramaDecodificado *decodificado);
+
+/*
+	Cria o diretório do cache de código nativo (--aot), caso não exista, e verifica se ele pode ser usado: os objetos do cache são
+	carregados com dlopen, então o diretório deve pertencer ao usuário efetivo e não pode ter escrita para o grupo ou os demais.
+	Retorna: TRUE caso o diretório seja confiável ou FALSE caso não.
+*/
+int prepararDiretorioNativo(const char *diretorio);
+
+/*
+	Verifica se o arquivo (ou diretório) pertence ao usuário efetivo e não tem permissão de escrita para o grupo ou os demais.
+	Retorna: TRUE caso seja confiável ou FALSE caso não.
+*/
+int verificarDonoArquivo(const char *caminho);
+
+/*
+	Prepara o código nativo do programa (--aot): carrega o objeto do cache ou, caso não exista, gera o código C, compila e guarda no cache.
+	Qualquer falha (sem compilador, sem permissão no diretório, ...) mantém decodificado->nativo em NULL e o programa é interpretado.
+	Retorna: TRUE caso o código nativo esteja disponível ou FALSE caso não.
+*/
+int compilarProgramaNativo(ProgramaDecodificado *decodificado, const char *nome);
+
+/*
+	Escreve a função SIMBOLO_NATIVO em C: um switch sobre o pc em que cada instrução é um case, e portanto um ponto de parada
+	(preempção) que retoma a execução na instrução seguinte.
+*/
+void gerarCodigoNativo(ProgramaDecodificado *decodificado, const char *nome, FILE *arquivo);
+
+/*
+	Compila o arquivo fonte C como biblioteca compartilhada, sem exibir as mensagens do compilador.
+	Retorna: TRUE ou FALSE caso o compilador não exista ou a compilação falhe.
+*/
+int executarCompilador(const char *fonte, const char *objeto);
+
+/*
+	Cria o cache de resultados em memória compartilhada, com a trava compartilhada entre processos.
+	Retorna: o cache ou NULL caso não seja possível criá-lo (a memoização fica desabilitada).
+*/
+CacheResultados * criarCacheResultados(int capacidade);
+
+/*
+	Obtém os valores que o programa da tarefa consome (os primeiros quantidadeLeituras valores): os valores enviados com a tarefa
+	ou, quando eles são digitados durante a execução, somente programas sem READ.
+	Retorna: a quantidade de entradas, ou NAO_ENCONTRADO caso o resultado da tarefa não possa ser memoizado.
+*/
+int obterEntradasMemoizacao(Tarefa *tarefa, const int **entradas);
+
+/*
+	Consulta o cache de resultados pelo programa e pelas entradas informadas, copiando o resultado encontrado em *resultado.
+	Retorna: TRUE em caso de acerto ou FALSE caso não.
+*/
+int consultarCacheResultados(ProgramaDecodificado *codigo, const int *entradas, int quantidadeEntradas, ResultadoMemoizado *resultado);
+
+/*
+	Guarda no cache o resultado de uma execução completa do programa com as entradas informadas, substituindo o resultado da posição.
+	O resultado só é guardado quando todas as escritas do programa foram registradas (e cabem em MAXIMO_ESCRITAS_MEMO).
+*/
+void guardarCacheResultados(ProgramaDecodificado *codigo, const int *entradas, int quantidadeEntradas, ResultadoMemoizado *resultado);
+
+/*
+	Posição do cache para o programa e as entradas informadas.
+*/
+int posicaoCacheResultados(unsigned long long hashPrograma, const int *entradas, int quantidadeEntradas);
+
+/*
+	Consulta o cache para cada tarefa antes da criação dos processos tes, marcando as tarefas memoizadas.
+*/
+void consultarMemoizacaoTarefas(Tarefa tarefas[], unsigned short quantidadeProgramas);
+
+/*
+	Guarda no cache o resultado da tarefa que executou o HALT, com o seu tempo de CPU e de E/S.
+*/
+void memoizarTarefa(DescritorTarefa *descritor);
+
+/*
+	Serve em um único passo o resultado da tarefa memoizada no seu primeiro escalonamento: escreve os valores guardados dos WRITEs,
+	contabiliza o tempo de E/S guardado e leva o pc ao HALT, com o restante do tempo de CPU guardado como ciclos pendentes. Os ciclos são
+	consumidos em bloco pelo escalonador, que mantém a preempção e as admissões nos mesmos instantes da execução interpretada.
+*/
+void servirTarefaMemoizada(DescritorTarefa *descritor);
+
+/*
+	Imprime as estatísticas do cache de resultados (consultas, acertos e ocupação).
+*/
+void exibirMemoizacao();
+
+/*
+	Converte a string em um número inteiro, exigindo que toda a string seja numérica (inclusive "0").
+	Retorna: TRUE caso seja um número ou FALSE caso não.
+*/
+int converterNumero(const char *str, int *valor);
+
+/*
+	Lê uma linha do arquivo de entradas (ignorando linhas vazias) e converte suas colunas em números inteiros.
+	Retorna: a quantidade de colunas numéricas lidas antes da primeira coluna inválida ou NAO_ENCONTRADO ao final do arquivo.
+*/
+int lerLinhaEntradas(FILE *arquivo, int valores[], int maximo);
+
+/*
+	Modo vetorial (--simd): executa o programa uma vez para cada linha do arquivo de entradas, processando
+	INSTANCIAS_POR_BLOCO instâncias por vez com kernels SIMD. As saídas são exibidas na ordem das linhas.
+	Retorna: EXIT_SUCCESS ou EXIT_FAILURE.
+*/
+int executarModoSimd(const char *nomePrograma, const char *arquivoEntradas);
+
+/*
+	Aloca um lote com capacidade para INSTANCIAS_POR_BLOCO instâncias do programa.
+	Retorna: TRUE caso consiga alocar ou FALSE caso não.
+*/
+int alocarLoteInstancias(LoteInstancias *lote, ProgramaDecodificado *programa);
+
+/*
+	Libera a memória do lote.
+*/
+void liberarLoteInstancias(LoteInstancias *lote);
+
+/*
+	Executa o programa decodificado sobre todas as instâncias do lote. Instâncias com erro são mascaradas.
+*/
+void executarLoteInstancias(ProgramaDecodificado *programa, LoteInstancias *lote, KernelAritmetico kernel);
+
+/*
+	Divide os registradores das instâncias pelo operando, mascarando (com erro) as instâncias com divisor 0.
+*/
+void dividirInstancias(int *registradores, const int *operandos, int escalar, int quantidade, unsigned char *erros, unsigned short *pcErro, unsigned short pc);
+
+/*
+	Seleciona o kernel aritmético mais largo suportado pelo processador (AVX2, SSE4.1 ou escalar).
+	Retorna: o kernel selecionado e armazena o seu nome em *nome.
+*/
+KernelAritmetico selecionarKernelAritmetico(const char **nome);
+
+/*
+	Seleciona o kernel de redução mais largo suportado pelo processador (AVX2, SSE4.1 ou escalar).
+	Retorna: o kernel selecionado.
+*/
+KernelReducao selecionarKernelReducao();
+
+/*
+	Kernels aritméticos do modo vetorial.
+*/
+void kernelAritmeticoEscalar(int codigo, int *registradores, const int *operandos, int escalar, int quantidade);
+void kernelAritmeticoSse41(int codigo, int *registradores, const int *operandos, int escalar, int quantidade);
+void kernelAritmeticoAvx2(int codigo, int *registradores, const int *operandos, int escalar, int quantidade);
+
+/*
+	Kernels de redução das instruções de vetor. Sem elementos, retornam o elemento neutro da operação.
+*/
+int kernelReducaoEscalar(int codigo, const int *valores, int quantidade);
+int kernelReducaoSse41(int codigo, const int *valores, int quantidade);
+int kernelReducaoAvx2(int codigo, const int *valores, int quantidade);
+
+/*
+	Combina dois resultados parciais de uma redução.
+	Retorna: o resultado combinado.
+*/
+int combinarReducao(int codigo, int resultado, int parcial);
+
+/*
+	Modo map (--map): executa o programa uma vez para cada linha do arquivo de entradas utilizando o interpretador,
+	com uma thread por núcleo. As linhas são distribuídas em blocos de LINHAS_POR_BLOCO_MAP e as saídas são
+	escritas na ordem das linhas.
+	Retorna: EXIT_SUCCESS ou EXIT_FAILURE.
+*/
+int executarModoMap(const char *nomePrograma, const char *arquivoEntradas, const char *arquivoSaida);
+
+/*
+	Thread de leitura do modo map: lê os blocos de linhas do arquivo de entradas enquanto houver blocos livres.
+*/
+void * lerBlocosMap(void *argumento);
+
+/*
+	Thread de execução do modo map: executa os blocos lidos até que todos tenham sido executados.
+*/
+void * executarBlocosMap(void *argumento);
+
+/*
+	Executa o programa para cada linha do bloco, armazenando as escritas e os erros em bloco->saida.
+*/
+void executarBlocoMap(Tarefa *tarefa, BlocoMap *bloco);
+
+/*
+	Modo servidor (--servidor): aguarda pedidos no socket Unix informado e executa cada um em um processo filho, com os
+	executores de processos tes do modo interativo. No máximo 'concorrencia' trabalhos executam ao mesmo tempo; os demais
+	pedidos aguardam na fila do socket.
+	Retorna: EXIT_FAILURE caso o socket não possa ser criado (em caso de sucesso, não retorna).
+*/
+int executarModoServidor(const char *caminho, int concorrencia);
+
+/*
+	Executa o trabalho de um cliente do modo servidor: lê o pedido, carrega e verifica os programas e os executa.
+	A saída padrão é redirecionada para o socket do cliente. Encerra o processo ao final.
+	A vaga (0 a concorrencia - 1) desloca a afinidade dos processos tes, para que trabalhos simultâneos não usem os mesmos núcleos.
+	As latências dos processos tes são combinadas na distribuição do trabalho, que é acumulada em latenciasServidor (a distribuição
+	de todos os trabalhos atendidos pelo servidor, compartilhada entre os processos); ambas são enviadas ao cliente.
+*/
+void atenderCliente(int cliente, int vaga, HistogramasLatencia *latenciasServidor);
+
+/*
+	Lê um pedido do modo servidor (ver COMANDO_PROGRAMA) e carrega os programas nas tarefas; as entradas de cada tarefa são
+	guardadas na linha correspondente de 'entradas'. Programas inexistentes são ignorados, como no modo interativo.
+	Retorna: a quantidade de programas carregados, ou 0 caso o pedido seja inválido.
+*/
+unsigned short lerPedido(FILE *entrada, Tarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS], int entradas[NUMERO_MAXIMO_DE_PROGRAMAS][MAXIMO_ENTRADAS_EXECUCAO]);
+
+/*
+	Escreve no arquivo os dados do erro ocorrido na execução de uma linha de entrada.
+*/
+void imprimirErroLinha(FILE *arquivo, const char *nome, unsigned long linha, ErroExecucao erro);
+
+/*
+	Exibe as saídas (ou o erro) de cada instância do lote, uma linha por instância.
+*/
+void exibirSaidasLote(ProgramaDecodificado *programa, LoteInstancias *lote, Programa *fonte, unsigned long primeiraLinha);
+
+/*
+	Busca e executa a proxima instrução do programa desejado.
+	O programa deve ter sido verificado na carga (obterImagemPrograma): as instruções já estão decodificadas e não são validadas novamente.
+	Enquanto a tarefa tiver ut pendentes de uma instrução de vetor, consome uma ut sem executar instruções.
+	Retorna: RETURN_OK, RETURN_FIM, RETURN_ES ou RETURN_ERRO (conforme executarInstrucao).
+*/
+int interpretador(unsigned short indiceTarefa, MaquinaExecucao *maquina);
+
+/*
+	Executa ums instrução LPAS decodificada. Em caso de erro, os dados do erro são armazenados em maquina->erroExecucao.
+	Retorna:
+		RETURN_ERRO: Caso ocorra algum erro durante a execução.
+		RETURN_OK: Caso a execução seja bem sucedida.
+		RETURN_FIM: Caso a instrução informada seja HALT.
+		RETURN_ES: Caso a instrução seja um READ ou VREAD e a E/S seja bloqueante (maquina->latenciaES > 0).
+*/
+int executarInstrucao(const InstrucaoDecodificada *instrucao, unsigned short indiceTarefa, MaquinaExecucao *maquina);
+
+/*
+	Exibe o prompt “READ: ”, lê um valor inteiro do teclado e armazena na variável correspondente.
+	Retorna:
+		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
+		Código de erro: Caso ocorra algum erro.
+*/
+int lpasRead(const InstrucaoDecodificada *instrucao, unsigned short indiceTarefa, MaquinaExecucao *maquina);
+
+/*
+	Escreve na tela a mensagem “WRITE: ”, seguida do valor armazenado na variável informada ou o dígito numérico que acompanha a instrução.
+	Retorna:
+		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
+		Código de erro: Caso ocorra algum erro.
+*/
+int lpasWrite(const InstrucaoDecodificada *instrucao, unsigned short indiceTarefa, MaquinaExecucao *maquina);
+
+/*
+	Carrega para o registrador da máquina o valor de uma variável ou o dígito numérico que acompanha a instrução.
+	Retorna:
+		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
+		Código de erro: Caso ocorra algum erro.
+*/
+int lpasLoad(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina);
+
+/*
+	Adiciona o valor do registrador ao valor de uma variável ou número e armazena o resultado no registrador.
+	Retorna:
+		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
+		Código de erro: Caso ocorra algum erro.
 */
-int buscarEnderecoVariavelUsandoNome(Instrucao dado, MaquinaExecucao *maquina);
+int lpasAdd(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina);
 
 /*
-	Obtém o valor numérico do argumento de uma instrução LPAS e armazena no local referenciado pelo ponteiro *valor.
-	> Se for uma variável: Busca no vetor de variáveis utilizando o nome.
-	> Se for um número: Converte de string para int.
+	Subtrai o valor do registrador do valor de uma variável ou número e armazena o resultado no registrador.
 	Retorna:
 		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
 		Código de erro: Caso ocorra algum erro.
 */
-int obterValorNumericoDoArgumento(Instrucao dado, MaquinaExecucao *maquina, int *valor);
+int lpasSub(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina);
+
+/*
+	Multiplica o valor do registrador com valor de uma variável ou número e armazena o resultado no registrador.
+	Retorna:
+		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
+		Código de erro: Caso ocorra algum erro.
+*/
+int lpasMul(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina);
+
+/*
+	Divide o valor do registrador pelo valor de uma variável ou número e armazena o resultado no registrador.
+	Retorna:
+		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
+		Código de erro: Caso ocorra algum erro.
+*/
+int lpasDiv(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina);
+
+/*
+	Armazena o valor do registrador em uma variável.
+	Retorna:
+		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
+		Código de erro: Caso ocorra algum erro.
+*/
+int lpasStore(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina);
+
+/*
+	Executa uma instrução de vetor e reserva as demais ut do seu custo em ciclosPendentes, consumidas pelo interpretador.
+	Retorna:
+		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
+		Código de erro: Caso ocorra algum erro.
+*/
+int executarInstrucaoVetor(const InstrucaoDecodificada *instrucao, unsigned short indiceTarefa, MaquinaExecucao *maquina);
+
+/*
+	Cria o vetor (ARRAY) com todos os elementos iguais a 0.
+	Retorna: EXECUCAO_BEM_SUCEDIDA.
+*/
+int lpasArray(const OperandosVetor *vetor, MaquinaExecucao *maquina);
+
+/*
+	Exibe o prompt “VREAD: ” e lê um valor para cada elemento do vetor (ou os obtém das entradas informadas).
+	Retorna:
+		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
+		SIMBOLO_INVALIDO: Caso não haja valores suficientes.
+*/
+int lpasVread(const OperandosVetor *vetor, unsigned short indiceTarefa, MaquinaExecucao *maquina);
+
+/*
+	Escreve na tela a mensagem “VWRITE: ”, seguida dos elementos do vetor.
+	Retorna: EXECUCAO_BEM_SUCEDIDA.
+*/
+int lpasVwrite(const OperandosVetor *vetor, unsigned short indiceTarefa, MaquinaExecucao *maquina);
+
+/*
+	Aplica VADD, VSUB, VMUL ou VDIV elemento a elemento sobre o vetor de destino, com o kernel SIMD selecionado (a divisão é escalar).
+	Retorna:
+		EXECUCAO_BEM_SUCEDIDA: Caso execute sem erros.
+		ARGUMENTO_INSTRUCAO_LPAS_INVALIDO: Caso algum divisor seja 0 (o vetor não é alterado).
+*/
+int lpasOperacaoVetor(int codigo, const OperandosVetor *vetor, MaquinaExecucao *maquina);
 
 /*
-	Verifica a instrução e obtém o seu argumento (dado).
+	Calcula VSUM, VMIN ou VMAX dos elementos do vetor e armazena o resultado no registrador.
+	Retorna: EXECUCAO_BEM_SUCEDIDA.
+*/
+int lpasReducaoVetor(int codigo, const OperandosVetor *vetor, MaquinaExecucao *maquina);
+
+/*
+	Obtém o próximo valor de entrada da tarefa: das entradas do lote (modo map), das entradas enviadas com a tarefa (modo servidor) ou do teclado.
+	Retorna: TRUE caso o valor seja lido ou FALSE caso não.
+*/
+int lerValorEntrada(unsigned short indiceTarefa, MaquinaExecucao *maquina, int *valor);
+
+/*
+	Obtém o valor numérico do argumento de uma instrução LPAS decodificada.
+	> Se for uma variável: Lê a memória de dados no endereço resolvido na carga do programa.
+	> Se for um número: O próprio valor imediato.
+	Retorna: o valor do argumento.
+*/
+int obterValorOperando(const InstrucaoDecodificada *instrucao, MaquinaExecucao *maquina);
+
+/*
+	Verifica a instrução e obtém o seu argumento (dado), continuando a separação iniciada por identificarInstrucao.
+	O contexto da separação é local à thread, permitindo executar o interpretador em várias threads.
 	Retorna: String (char *) contendo o argumento ou NULL caso não exista. 
 */
 char * obterArgumento();
@@ -407,6 +1556,8 @@ void inicializarMaquinaExecucao(Tarefa tarefas[], unsigned short quantidadeProgr
 
 /*
 	Inicia os campos das Contextos com os devidos dados.
+	> Aloca a memória de dados de cada tarefa com o número de variáveis do programa.
+	Caso não seja possível alocar a memória, a função finaliza o programa.
 */
 void inicializarContextos(unsigned short quantidadeProgramas, MaquinaExecucao *maquina);
 
@@ -420,12 +1571,39 @@ void carregarContextoParaMaquina(unsigned short indexTarefa, MaquinaExecucao *ma
 */
 void salvarContextoDaMaquina(unsigned short indexTarefa, MaquinaExecucao *maquina);
 
+/*
+	Calcula quantas instruções o código nativo (ou quantos ciclos pendentes) pode executar em bloco sem passar por um evento
+	do escalonador: o fim da volta (restantes), a preempção por tempo e as verificações do watchdog. Somente a última instrução do bloco
+	pode gerar um desses eventos.
+	Retorna: o tamanho do bloco (pelo menos 1).
+*/
+unsigned calcularLoteInstrucoes(RoundRobin *roudRobin, DescritorTarefa *descritor, UnidadeTempo restantes, int outraPronta, int verificarRelogio);
+
 /*
 	Verifica se há tarefas com estado o informado no parâmetro.
 	Retorna: indice (index) da primeira tarefa (com estado correspondente) encontrada ou NAO_ENCONTRADO caso não encontre.
 */
 int verificarEstadoTarefas(DescritorTarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS], unsigned short quantidade, EstadoTarefa estado);
 
+/*
+	Procura a primeira tarefa NOVA cujo instante de chegada já foi alcançado pelo relógio (ut) do processo.
+	Retorna: indice (index) da tarefa ou NAO_ENCONTRADO caso nenhuma tarefa tenha chegado.
+*/
+int verificarChegadas(MaquinaExecucao *maquina, UnidadeTempo agora);
+
+/*
+	Procura o separador do instante de chegada (nome@ut): o último SEPARADOR_CHEGADA, desde que seja seguido somente por dígitos.
+	Um caminho que contém o separador sem um instante (ex.: dir@v2/prog) não tem chegada.
+	Retorna: o endereço do separador ou NULL caso o nome não informe a chegada.
+*/
+char * procurarSeparadorChegada(const char *nome);
+
+/*
+	Separa o instante de chegada do nome do programa (nome@ut), removendo-o do nome. Sem o separador, a chegada é 0.
+	Retorna: TRUE ou FALSE caso o instante seja maior que CHEGADA_MAXIMA.
+*/
+int separarChegada(char *nome, UnidadeTempo *chegada);
+
 /*
 	Verifica se há tarefas com estado diferente de TERMINADO na fila do processador ou na fila das tarefas NOVAs.
 	Retorna: TRUE caso tenha, ou FALSE caso não.
@@ -450,30 +1628,232 @@ void gerarPreempcaoPorTempo(MaquinaExecucao *maquina, RoundRobin *roudRobin, uns
 /*
 	Finaliza a tarefa indicada pelo indesFila.
 	> Determina seu estado como TERMINADA.
+	> Libera a memória de dados da tarefa.
 	> Calcula e armazena o momento (ut) que a tareda saiu da fila da CPU.
 	> Reinicia a contagem da preempção.
 */
 void terminarTarefa(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short indexFila);
 
+/*
+	Watchdog: verifica se a tarefa em execução excedeu o limite de tempo de CPU ou, quando verificarRelogio for TRUE ou a cada
+	INTERVALO_WATCHDOG instruções, o prazo de tempo de relógio.
+	Retorna: TRUE caso a tarefa tenha excedido um dos limites ou FALSE caso não.
+*/
+int excedeuLimite(DescritorTarefa *descritor, int verificarRelogio);
+
+/*
+	Aborta a tarefa que excedeu um dos seus limites.
+	> Exibe o erro LIMITE_EXCEDIDO, com a última instrução executada pela tarefa.
+	> Marca a tarefa como abortada e a termina.
+*/
+void abortarTarefa(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short index);
+
+/*
+	Suspende a tarefa em execução, que executou um READ bloqueante.
+	> Determina seu estado como SUSPENSA até o instante (ut) do fim da E/S.
+	> Salva o contexto da tarefa e passa a fila para a próxima tarefa.
+	> Reinicia a contagem da preempção.
+*/
+void suspenderTarefa(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short *indexFila);
+
+/*
+	Devolve à fila (estado PRONTA) as tarefas SUSPENSAS cuja E/S termina até o instante atual (roudRobin->contadorCPU).
+*/
+void despertarTarefas(MaquinaExecucao *maquina, RoundRobin *roudRobin);
+
+/*
+	Calcula o instante (ut) do próximo evento que altera a fila do escalonador: a chegada de uma tarefa NOVA (no seu instante de chegada)
+	ou o fim da E/S de uma tarefa SUSPENSA.
+	O fim do quantum não entra no cálculo, pois é verificado a cada instrução executada.
+	Retorna: o instante do próximo evento, ou limite caso nenhum evento ocorra antes dele.
+*/
+UnidadeTempo calcularProximoEvento(MaquinaExecucao *maquina, RoundRobin *roudRobin, UnidadeTempo limite);
+
 /*
 	Imprime na saída padrão (stdout) os dados do erro passado por parâmetro.
 */
 void imprimirDadosErro(ErroExecucao erro);
 
 /*
-	Imprime na saída padrão (stdout) os dados do processo executado.
+	Registra um evento do escalonador no buffer circular. Não faz nada caso o registro esteja desabilitado.
+*/
+void registrarEvento(RegistroEventos *registro, TipoEvento tipo, unsigned short tarefa, int estadoAnterior, int estadoNovo, UnidadeTempo ut, int erro);
+
+/*
+	Escreve o texto no arquivo como o conteúdo de uma string JSON: aspas, barras invertidas e caracteres de controle são escapados.
+*/
+void escreverTextoJson(FILE *arquivo, const char *texto);
+
+/*
+	Grava os eventos registrados no formato JSON do Chrome trace (chrome://tracing, ui.perfetto.dev):
+	um intervalo por estado de cada tarefa e eventos instantâneos para preempções, erros e migrações.
+	Retorna: TRUE caso consiga gravar o arquivo ou FALSE caso não.
+*/
+int exportarTraceChrome(RegistroEventos *registro, MaquinaExecucao *maquina, unsigned short tes, const char *prefixo);
+
+/*
+	Exibe o diagrama de Gantt das tarefas (uma coluna por ut), reconstruído a partir dos eventos registrados.
+	'#' = EXECUTANDO, '.' = PRONTA, 's' = SUSPENSA, 'E' = erro, 'M' = migrada para outro processo.
+	Com o registro circular cheio, o diagrama começa no primeiro evento guardado e '?' marca o estado ainda desconhecido de cada tarefa.
+	Acima de LARGURA_MAXIMA_GANTT ut, cada coluna representa várias ut.
+*/
+void exibirGantt(RegistroEventos *registro, MaquinaExecucao *maquina, UnidadeTempo totalUt);
+
+/*
+	Marca no diagrama de Gantt as colunas das ut [de, ate) com o símbolo, sem substituir um símbolo mais relevante da mesma coluna
+	(erro e migração prevalecem sobre os estados).
+*/
+void marcarColunasGantt(char *linha, UnidadeTempo de, UnidadeTempo ate, char simbolo, UnidadeTempo inicioGrafico, UnidadeTempo escala, UnidadeTempo totalUt);
+
+/*
+	Conta as tarefas com o estado informado no parâmetro.
+	Retorna: a quantidade de tarefas encontradas.
+*/
+int contarEstadoTarefas(DescritorTarefa tarefas[NUMERO_MAXIMO_DE_PROGRAMAS], unsigned short quantidade, EstadoTarefa estado);
+
+/*
+	Atualiza as medidas de tempo de relógio da tarefa na transição de estado informada.
+*/
+void medirTransicao(RoundRobin *roudRobin, unsigned short index, int estadoAnterior, int estadoNovo);
+
+/*
+	Calcula o tempo de espera da tarefa na fila deste processo: o tempo entre a entrada e a saída da fila menos o tempo de CPU e,
+	com E/S bloqueante, o tempo suspenso. Uma contabilização inconsistente nunca resulta em espera negativa.
+	Retorna: o tempo de espera (ut).
 */
-void exibirRelatorioProcesso(MaquinaExecucao maquina, RoundRobin roudRobin, unsigned short quantidadeProgramas, unsigned short tes);
+UnidadeTempo calcularTempoEspera(MaquinaExecucao *maquina, RoundRobin *roudRobin, unsigned short index);
+
+/*
+	Registra as latências (execução, espera e resposta) das tarefas executadas pelo processo nos histogramas.
+*/
+void registrarLatencias(MaquinaExecucao *maquina, RoundRobin *roudRobin, HistogramasLatencia *latencias);
+
+/*
+	Registra um valor no histograma.
+*/
+void registrarValorHistograma(Histograma *histograma, unsigned long long valor);
+
+/*
+	Retorna: o índice da faixa do histograma que contém o valor.
+*/
+int indiceFaixaHistograma(unsigned long long valor);
+
+/*
+	Retorna: o maior valor contido na faixa do histograma.
+*/
+unsigned long long limiteFaixaHistograma(int faixa);
+
+/*
+	Retorna: o percentil (0 < percentil <= 1) do histograma, com a precisão das faixas e limitado ao maior valor registrado.
+*/
+unsigned long long percentilHistograma(Histograma *histograma, double percentil);
+
+/*
+	Acumula os histogramas de origem nos de destino com operações atômicas, para que vários processos possam acumular
+	os seus histogramas na mesma memória compartilhada.
+*/
+void combinarHistogramas(HistogramasLatencia *destino, HistogramasLatencia *origem);
+
+/*
+	Exibe p50, p90, p99 e o máximo de cada latência, em ut e em us.
+*/
+void exibirLatencias(HistogramasLatencia *latencias);
+
+/*
+	Exibe os percentis das latências combinadas de vários processos tes com o título informado, caso alguma tarefa tenha sido registrada.
+*/
+void exibirLatenciasCombinadas(const char *titulo, HistogramasLatencia *latencias);
+
+/*
+	Aloca (zerados) os histogramas de latência em memória compartilhada com os processos filhos.
+	Retorna: os histogramas ou NULL caso não seja possível alocá-los.
+*/
+HistogramasLatencia * criarHistogramasCompartilhados();
+
+/*
+	Libera os histogramas alocados por criarHistogramasCompartilhados.
+*/
+void destruirHistogramasCompartilhados(HistogramasLatencia *latencias);
+
+/*
+	Lê uma lista de núcleos no formato do Linux (ex.: "0,2,4-7") e acrescenta os núcleos ao conjunto.
+	Retorna: TRUE ou FALSE caso a lista seja inválida.
+*/
+int lerListaNucleos(const char *lista, cpu_set_t *conjunto);
+
+/*
+	Escreve o conjunto de núcleos no formato de lista do Linux (ex.: "0,2,4-7").
+*/
+void formatarListaNucleos(cpu_set_t *conjunto, char *lista, size_t tamanho);
+
+/*
+	Ordena os núcleos do conjunto em configuracao->ordemNucleos: primeiro o primeiro núcleo lógico de cada núcleo físico
+	(segundo /sys/devices/system/cpu/cpuN/topology/thread_siblings_list), depois os seus irmãos de hyperthread.
+*/
+void ordenarNucleos(cpu_set_t *conjunto, Configuracao *configuracao);
+
+/*
+	Fixa o processo tes de índice informado em seu núcleo (ou no conjunto de núcleos, com --afinidade-compartilhada) com sched_setaffinity.
+*/
+void aplicarAfinidade(int indiceProcesso);
+
+/*
+	Imprime os núcleos em que o processo pode executar, o núcleo atual e as trocas de contexto do processo.
+*/
+void exibirProcessador();
+
+/*
+	Abre o grupo de contadores de hardware do processo com perf_event_open, medindo somente o código do processo em modo usuário (o que
+	dispensa privilégios com perf_event_paranoid até 2). Um contador que o processador não oferece fica indisponível sem impedir os demais.
+	Retorna: TRUE ou FALSE caso os ciclos (líder do grupo) não possam ser medidos, com o motivo em errno.
+*/
+int abrirContadoresHardware(GrupoContadores *grupo);
+
+/*
+	Lê todos os contadores do grupo com uma única chamada read. Os valores são corrigidos caso o núcleo tenha multiplexado o grupo com
+	outros contadores, e os contadores indisponíveis são lidos como 0.
+	Retorna: TRUE ou FALSE caso a leitura falhe.
+*/
+int lerContadoresHardware(const GrupoContadores *grupo, unsigned long long valores[]);
+
+/*
+	Encerra uma fase da medição: lê os contadores, acumula em *fase a diferença em relação à leitura anterior e guarda a nova leitura.
+*/
+void encerrarFaseContadores(const GrupoContadores *grupo, ContadoresHardware *fase, unsigned long long leitura[]);
+
+/*
+	Fecha os descritores do grupo de contadores.
+*/
+void fecharContadoresHardware(GrupoContadores *grupo);
+
+/*
+	Imprime os contadores de uma fase como IPC e como ciclos, desvios mal previstos e falhas de cache por unidade (instrução LPAS ou volta
+	do escalonador). Os contadores indisponíveis são exibidos como "n/d".
+*/
+void exibirContadoresHardware(const GrupoContadores *grupo, const ContadoresHardware *fase, unsigned long long quantidade, const char *unidade);
+
+/*
+	Imprime na saída padrão (stdout) os dados do processo executado, incluindo os percentis das latências das suas tarefas.
+*/
+void exibirRelatorioProcesso(MaquinaExecucao maquina, RoundRobin roudRobin, unsigned short quantidadeProgramas, unsigned short tes, HistogramasLatencia *latencias);
 
 /*
 	Efetivamente cria um processo utilizando a função fork().
-	Caso ocorra um erro no processo de criação do processo, a função finaliza o programa.
+	A saída padrão é descarregada antes, para que o processo filho não repita textos ainda no buffer.
 	Retorna: 
 		- 0 para o processo Filho.
 		- PID do processo filho ou -1, caso ocorra algum erro, para o processo Pai.
 */
 pid_t criarProcesso();
 
+/*
+	Encerra um processo filho (processo tes ou trabalho do modo servidor): descarrega a saída padrão e termina com _exit.
+	O filho é criado enquanto as threads de carga do pai podem estar no meio de um dlopen (--aot) ou de uma operação de stdio:
+	as travas que elas detinham são herdadas fechadas, e o exit() (flush de todos os arquivos, destrutores das bibliotecas) poderia
+	bloquear o filho para sempre.
+*/
+void encerrarProcessoFilho(int status);
+
 /*
 	Percorre o arquivo, lê as instruções e as armazena no Programa.
 	Retorna: O número de instruções lidas.